@@ -1,4 +1,10 @@
 #include "common.h"
+#include "compose.h"
+#include "fb.h"
+#include "file.h"
+#include "perf.h"
+#include "sched.h"
+#include "swapchain.h"
 #include "user/elf/elf.h"
 
 extern unsigned char _bss_dmem_begin;
@@ -15,24 +21,32 @@ void mmu_table_section(uint32_t *table, uint32_t vaddr, uint32_t paddr, uint32_t
     *table_addr = table_val;
 }
 
-struct fb {
-    uint32_t pwidth;
-    uint32_t pheight;
-    uint32_t vwidth;
-    uint32_t vheight;
-    uint32_t pitch;
-    uint32_t bpp;
-    uint32_t xoffs;
-    uint32_t yoffs;
-    uint32_t buf;
-    uint32_t size;
-};
-
-struct fb f;
-
-static volatile bool new_frame = false;
-static volatile uint8_t bufid = 0;
-#define BUF_COUNT   4
+static struct swapchain sc;
+#define BUF_COUNT   SWAP_MAX
+// Buffer being rendered by the main loop
+static uint8_t back_id = 0;
+// Policy | (count << 8) requested by the application, applied between frames
+static volatile int32_t swap_request = -1;
+
+// Paces update() and draw() on the vertical tick
+static struct sched sd;
+// Timing table printed over each presented frame
+static bool perf_hud_on = false;
+// Display mode requested by the application, applied between frames
+static volatile bool mode_request = false;
+static uint32_t mode_w, mode_h, mode_bpp, mode_order;
+
+// Regions reported by the application for the frame being drawn, and
+// regions of each slice that are behind the application's buffer
+static struct damage frame_damage;
+static bool frame_damage_reported = false;
+static struct damage slot_damage[BUF_COUNT];
+
+// Address of a framebuffer slice in the application's address space
+static inline uint8_t *user_fb(uint8_t id)
+{
+    return (uint8_t *)(USER_FB_BASE + (f.buf & 0xfffff) + f.pitch * f.pheight * id);
+}
 
 void wait(uint32_t ticks)
 {
@@ -65,36 +79,6 @@ void murmur(uint32_t num)
     DMB();
 }
 
-uint32_t set_pixel_order(uint32_t val)
-{
-    static mbox_buf(4) buf __attribute__((section(".bss.dmem"), aligned(16)));
-    mbox_init(buf);
-    buf.tag.id = 0x00048006;   // Set pixel order
-    buf.tag.u32[0] = val;
-    mbox_emit(buf);
-    return buf.tag.u32[0];
-}
-
-uint32_t get_pixel_order()
-{
-    static mbox_buf(4) buf __attribute__((section(".bss.dmem"), aligned(16)));
-    mbox_init(buf);
-    buf.tag.id = 0x40006;   // Get pixel order
-    buf.tag.u32[0] = 123;
-    mbox_emit(buf);
-    return buf.tag.u32[0];
-}
-
-void set_virtual_offs(uint32_t x, uint32_t y)
-{
-    static mbox_buf(8) buf __attribute__((section(".bss.dmem"), aligned(16)));
-    mbox_init(buf);
-    buf.tag.id = 0x48009;   // Set virtual offset
-    buf.tag.u32[0] = x;
-    buf.tag.u32[1] = y;
-    mbox_emit(buf);
-}
-
 uint32_t get_clock_rate(uint8_t id)
 {
     static mbox_buf(8) buf __attribute__((section(".bss.dmem"), aligned(16)));
@@ -137,6 +121,21 @@ uint32_t get_max_clock_rate()
     return buf.tag.u32[1];
 }
 
+static void console_scroll(uint32_t offs)
+{
+    // The framebuffer is cached; make the new line visible first
+    _clean_data_cache();
+    DSB();
+    set_virtual_offs(0, offs);
+}
+
+// Boot log and fault messages, scrolling through all framebuffer slices
+static void console_init()
+{
+    print_console((uint8_t *)f.buf, f.pwidth, f.pheight, f.vheight,
+        f.pitch, f.bpp, console_scroll);
+}
+
 void __attribute__((interrupt("UNDEFINED"))) _int_uinstr()
 {
     // TODO: Handle bounced instructions from FPU (ARM ARM p. C2-26)
@@ -145,9 +144,7 @@ void __attribute__((interrupt("UNDEFINED"))) _int_uinstr()
     r14 -= 4;
     _set_domain_access((3 << 2) | 3);
     DSB();
-    print_init((uint8_t *)(f.buf + f.pitch * f.pheight * bufid),
-        f.pwidth, f.pheight, f.pitch);
-    set_virtual_offs(0, bufid * f.pheight);
+    console_init();
     printf("Undefined Instruction %x\n", r14);
     DMB();
     while (1) { murmur(2); wait(1000000); }
@@ -157,9 +154,7 @@ void __attribute__((interrupt("UNDEFINED"))) _int_uhandler()
 {
     _set_domain_access((3 << 2) | 3);
     DSB();
-    print_init((uint8_t *)(f.buf + f.pitch * f.pheight * bufid),
-        f.pwidth, f.pheight, f.pitch);
-    set_virtual_offs(0, bufid * f.pheight);
+    console_init();
     printf("Undefined Handler\n");
     DMB();
     while (1) { murmur(3); wait(1000000); }
@@ -186,6 +181,63 @@ static volatile draw_func_t _draw = NULL;
 
 static uint32_t _buttons = 0;
 
+// Validates a layer description from the application. What the layer
+// covered before and covers now has to be recomposed in every slice.
+static uint32_t set_layer(uint32_t index, uint32_t desc)
+{
+    const struct layer *old = compose_get(index);
+    if (old == NULL) return 0;
+    struct rect was = old->r;
+    bool was_on = (old->mode != LAYER_OFF);
+
+    struct layer l = { LAYER_OFF };
+    if (desc != 0) {
+        if (!user_range(desc, sizeof(struct layer_desc))) return 0;
+        // Validated and used from one copy, whatever the application
+        // does to its own
+        struct layer_desc ld = *(const struct layer_desc *)desc;
+        if (ld.mode == LAYER_OFF || ld.mode > LAYER_FILL) return 0;
+        if (ld.w == 0 || ld.h == 0 ||
+            ld.x >= f.pwidth || ld.y >= f.pheight) return 0;
+        l.mode = ld.mode;
+        l.alpha = ld.alpha + (ld.alpha >> 7);
+        l.key = ld.key;
+        l.r.x = ld.x;
+        l.r.y = ld.y;
+        l.r.w = (ld.x + ld.w > f.pwidth ? f.pwidth - ld.x : ld.w);
+        l.r.h = (ld.y + ld.h > f.pheight ? f.pheight - ld.y : ld.h);
+        l.pitch = ld.w * fb_bypp();
+        if (l.mode != LAYER_FILL) {
+            uint32_t p = (uint32_t)ld.pixels;
+            if (!user_range(p, (uint64_t)l.pitch * ld.h)) return 0;
+            // Whole pixels are loaded at once for 16 and 32 bpp
+            if (p % (fb_bypp() == 3 ? 1 : fb_bypp()) != 0) return 0;
+            l.buf = (const uint8_t *)p;
+        }
+        // The background is copied as a whole frame by the DMA engine
+        if (index == 0 && (l.mode != LAYER_OPAQUE ||
+            l.r.x != 0 || l.r.y != 0 || ld.w != f.pwidth || ld.h != f.pheight))
+            return 0;
+    }
+    compose_set(index, desc != 0 ? &l : NULL);
+
+    for (uint8_t i = 0; i < BUF_COUNT; i++) {
+        if (was_on) damage_add(&slot_damage[i], was, f.pwidth, f.pheight);
+        if (desc != 0) damage_add(&slot_damage[i], l.r, f.pwidth, f.pheight);
+    }
+    return 1;
+}
+
+// Applies a cache operation to the rows of each rectangle in a slice
+static void slice_rects(uint8_t *slice, const struct rect *r, uint32_t count,
+    void (*op)(uint32_t, uint32_t))
+{
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t start = (uint32_t)slice + r[i].y * f.pitch + r[i].x * fb_bypp();
+        op(start, start + (r[i].h - 1) * f.pitch + r[i].w * fb_bypp());
+    }
+}
+
 uint32_t _int_swi(uint32_t r0, uint32_t r1, uint32_t r2)
 {
     _set_domain_access((3 << 2) | 3);
@@ -198,6 +250,82 @@ uint32_t _int_swi(uint32_t r0, uint32_t r1, uint32_t r2)
         _draw = (draw_func_t)r2;
     } else if (r0 == 2) {
         ret = _buttons;
+    } else if (r0 == 5) {
+        // Applications draw tightly packed rows; padded ones need the copy
+        if (f.pitch == f.pwidth * fb_bypp()) ret = (uint32_t)user_fb(back_id);
+    } else if (r0 == 6) {
+        const struct rect *r = (const struct rect *)r1;
+        if (r2 <= DAMAGE_MAX && user_range(r1, r2 * sizeof(struct rect))) {
+            for (uint32_t i = 0; i < r2; i++)
+                damage_add(&frame_damage, r[i], f.pwidth, f.pheight);
+            frame_damage_reported = true;
+        }
+    } else if (r0 == 7) {
+        swap_request = (r1 & 0xff) | ((r2 & 0xff) << 8);
+    } else if (r0 == 8) {
+        switch (r1) {
+            case 0: ret = sc.presented; break;
+            case 1: ret = sc.flips; break;
+            case 2: ret = sc.dropped; break;
+            case 3: ret = sc.repeated; break;
+            case 4: ret = sd.updates; break;
+            case 5: ret = sd.skipped; break;
+            case 6: ret = sd.lost; break;
+            default: break;
+        }
+    } else if (r0 == 9) {
+        // Saturated rather than truncated: 256 must not turn into 0
+        sched_config(&sd, (r1 > 255 ? 255 : r1), (r2 > 255 ? 255 : r2));
+    } else if (r0 == 10) {
+        ret = perf_stat(r1, r2);
+    } else if (r0 == 11) {
+        perf_hud_on = (r1 != 0);
+    } else if (r0 == 12) {
+        uint32_t w = r1 & 0xffff, h = r1 >> 16;
+        uint32_t bpp = r2 & 0xff, order = (r2 >> 8) & 0xff;
+        if (w >= 16 && w <= 1920 && h >= 16 && h <= 1080 &&
+            (bpp == 16 || bpp == 24 || bpp == 32) && order <= FB_ORDER_RGB)
+        {
+            mode_w = w; mode_h = h;
+            mode_bpp = bpp; mode_order = order;
+            mode_request = true;
+            ret = 1;
+        }
+    } else if (r0 == 13) {
+        ret = display_w | (display_h << 16);
+    } else if (r0 == 14) {
+        ret = set_layer(r1, r2);
+    } else if (r0 == 15) {
+        ret = file_open(r1, r2);
+    } else if (r0 == 16) {
+        ret = file_close(r1);
+    } else if (r0 == 17) {
+        ret = file_read(r1, r2);
+    } else if (r0 == 18) {
+        ret = file_seek(r1, r2);
+    } else if (r0 == 19) {
+        ret = file_stat(r1, r2);
+    } else if (r0 == 20) {
+        ret = file_opendir(r1);
+    } else if (r0 == 21) {
+        ret = file_readdir(r1, r2);
+    } else if (r0 == 22) {
+        ret = file_write(r1, r2);
+    } else if (r0 == 23) {
+        ret = file_sync(r1);
+    } else if (r0 == 24) {
+        struct disk_stats ds;
+        disk_cache_stats(&ds);
+        switch (r1) {
+            case 0: ret = ds.hits; break;
+            case 1: ret = ds.misses; break;
+            case 2: ret = ds.reads; break;
+            case 3: ret = ds.bytes; break;
+            case 4: ret = ds.writes; break;
+            case 5: ret = ds.written; break;
+            case 6: ret = ds.errors; break;
+            default: break;
+        }
     } else if (r0 == 42) {
         *GPCLR1 = r1;
     } else if (r0 == 43) {
@@ -212,9 +340,7 @@ void __attribute__((interrupt("ABORT"))) _int_pfabort()
 {
     _set_domain_access((3 << 2) | 3);
     DSB();
-    print_init((uint8_t *)(f.buf + f.pitch * f.pheight * bufid),
-        f.pwidth, f.pheight, f.pitch);
-    set_virtual_offs(0, bufid * f.pheight);
+    console_init();
     printf("Prefetch Abort\n");
     DMB();
     while (1) { murmur(5); wait(1000000); }
@@ -226,9 +352,7 @@ void __attribute__((interrupt("ABORT"))) _int_dabort()
     __asm__ __volatile__ ("mov %0, lr" : "=g"(lr));
     _set_domain_access((3 << 2) | 3);
     DSB();
-    print_init((uint8_t *)(f.buf + f.pitch * f.pheight * bufid),
-        f.pwidth, f.pheight, f.pitch);
-    set_virtual_offs(0, bufid * f.pheight);
+    console_init();
     printf("Data Abort at %x\n", lr);
     DMB();
     while (1) {
@@ -314,13 +438,90 @@ void status_handler(unsigned int index, const USPiGamePadState *state)
     printf(" %04x\r", state->buttons);
 }
 
-void load_program(const elf_ehdr *ehdr, const elf_phdr *program)
+static bool elf_file_read(void *ctx, uint32_t offs, void *dst, uint32_t len)
+{
+    FIL *file = (FIL *)ctx;
+    UINT bread;
+    return (f_lseek(file, offs) == FR_OK &&
+        f_read(file, dst, len, &bread) == FR_OK && bread == len);
+}
+
+// Reads the segment from the file straight to its place in the user region
+uint8_t load_program(const elf_reader *r, const elf_phdr *program)
+{
+    if (program->vaddr < USER_BASE || program->vaddr >= USER_END ||
+        program->memsz > USER_END - program->vaddr)
+    {
+        return ELF_E_UNSUPPORT;
+    }
+    if (!r->read(r->ctx, program->offs, (void *)program->vaddr, program->filesz))
+        return ELF_E_INVALID;
+    memset((uint8_t *)program->vaddr + program->filesz, 0, program->memsz - program->filesz);
+    return ELF_E_NONE;
+}
+
+// The kernel's view of the framebuffer is cached, with explicit cleans
+// before each flip; the application sees the same sections at USER_FB_BASE
+static void map_fb(bool user)
+{
+    uint32_t base = (f.buf >> 20) << 20;
+    for (uint32_t p = base; p < f.buf + f.size; p += 0x100000) {
+        mmu_table_section(mm_sys, p, p, 8 | 4);
+        if (!user) continue;
+        mmu_table_section(mm_user, p, p, 8 | 4);
+        mmu_table_section(mm_user, USER_FB_BASE + (p - base), p, 8 | 4);
+    }
+}
+
+static void unmap_fb()
+{
+    uint32_t base = (f.buf >> 20) << 20;
+    for (uint32_t p = base; p < f.buf + f.size; p += 0x100000) {
+        mmu_table_section(mm_sys, p, p, 0);
+        mmu_table_section(mm_user, p, p, 0);
+        mm_user[(USER_FB_BASE + (p - base)) >> 20] = 0;
+    }
+}
+
+// Reallocates the framebuffer for the mode last requested through
+// syscall 12; keeps the previous mode if the firmware refuses
+static void apply_mode()
 {
-    const char *buf = (const char *)ehdr;
-    uint32_t empty_len =
-        (program->filesz < program->memsz ? program->memsz - program->filesz : 0);
-    memcpy((void *)program->vaddr, buf + program->offs, program->filesz);
-    memset((void *)program->vaddr + program->filesz, 0, empty_len);
+    mode_request = false;
+    // Nothing may be reading the old buffer from here on
+    wait_dma(dma_fence());
+    _disable_int();
+
+    struct fb old = f;
+    unmap_fb();
+    if (fb_alloc(mode_w, mode_h, mode_bpp, BUF_COUNT)) {
+        set_pixel_order(mode_order);
+    } else if (!fb_alloc(old.pwidth, old.pheight, old.bpp, BUF_COUNT)) {
+        // The firmware has let go of the old buffer too; there is nothing
+        // left to draw into, not even a console
+        while (1) { murmur(4); wait(1000000); }
+    }
+    map_fb(true);
+    // Flushing invalidates the cache without writing it back: the new f,
+    // the page tables and whatever the old mode left dirty go out first
+    _clean_data_cache();
+    DSB();
+    _flush_mmu_table();
+
+    memset((void *)f.buf, 0, f.pitch * f.vheight);
+    _clean_data_cache_range(f.buf, f.buf + f.pitch * f.vheight);
+    DSB();
+    // Queued frames are of the old mode
+    swapchain_config(&sc, sc.count, sc.policy);
+    set_virtual_offs(0, sc.shown * f.pheight);
+    damage_clear(&frame_damage);
+    frame_damage_reported = false;
+    for (uint8_t i = 0; i < BUF_COUNT; i++)
+        damage_full(&slot_damage[i], f.pwidth, f.pheight);
+    // Layers were laid out for the old size and depth
+    compose_reset();
+
+    _enable_int();
 }
 
 void timer3_handler(void *_unused)
@@ -332,12 +533,9 @@ void timer3_handler(void *_unused)
     t = t - t % 16667 + 16667;
     *SYSTMR_C3 = t;
 
-    if (!new_frame) {
-        // Flip
-        set_virtual_offs(0, bufid * f.pheight);
-        new_frame = true;
-        bufid = (bufid + 1) % BUF_COUNT;
-    }
+    sched_tick(&sd);
+    int8_t id = swapchain_flip(&sc);
+    if (id >= 0) set_virtual_offs(0, id * f.pheight);
 
     _set_domain_access((1 << 2) | 3);
 }
@@ -359,6 +557,7 @@ void kernel_main()
     DMB(); DSB();
     set_irq_handler(3, timer3_handler, NULL);
     DMB();
+    dma_init();
 
     // Prepare TLB
     for (uint32_t i = 0; i < 4096; i++) {
@@ -373,39 +572,31 @@ void kernel_main()
     _enable_mmu((uint32_t)mm_sys);
 
     // Set up framebuffer
-    static struct fb f_volatile __attribute__((section(".bss.dmem"), aligned(16))) = { 0 };
-    f_volatile.pwidth = 256;
-    f_volatile.pheight = 256;
-    f_volatile.vwidth = 256;
-    f_volatile.vheight = 256 * BUF_COUNT;
-    f_volatile.bpp = 24;
-    send_mail(((uint32_t)&f_volatile + 0x40000000) >> 4, MAIL0_CH_FB);
-    recv_mail(MAIL0_CH_FB);
-
-    f = f_volatile;
+    if (!fb_alloc(256, 256, 24, BUF_COUNT)) while (1) { } // !
+    swapchain_init(&sc, 2, SWAP_LOW_LATENCY);
+    sched_init(&sd, SCHED_MAX_CATCHUP, SCHED_MAX_SKIP);
 
     uint8_t *buf = (uint8_t *)(f.buf);
-    for (uint32_t y = 0; y < f.vheight; y++)
-    for (uint32_t x = 0; x < f.vwidth; x++) {
-        buf[y * f.pitch + x * 3 + 2] =
-        buf[y * f.pitch + x * 3 + 1] =
-        buf[y * f.pitch + x * 3 + 0] = 255;
-    }
+    memset(buf, 255, f.pitch * f.vheight);
 
-    uint32_t buf_p = (uint32_t)buf;
-    buf_p = (buf_p >> 20) << 20;
     // Region attributes: B4-12
     // Descriptor: B4-27
     // AP = (3 bits << 12), C = 8, B = 4
-    for (uint32_t i = 0; i < 4; i++)
-        mmu_table_section(mm_sys, buf_p + (i << 20), buf_p + (i << 20), 12);
+    map_fb(false);
+    // As in apply_mode(): the flush drops dirty lines
+    _clean_data_cache();
+    DSB();
     _flush_mmu_table();
 
     DMB();
-    print_init(buf, f.pwidth, f.pheight, f.pitch);
+    console_init();
     printf("Hello world!\nHello MIKAN!\n");
     printf("abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz\n\n");
     printf("%d %d\n", dmem_start, dmem_end);
+    printf("Display %ux%u\n", display_w, display_h);
+#ifdef MEM_BENCH
+    mem_bench();
+#endif
     DSB();
 
     uint32_t ret = set_pixel_order(0);
@@ -492,27 +683,21 @@ reselect:
         if ((b0 & BUTTON_CRO) && !(b1 & BUTTON_CRO))
             selected = true;
         // Draw
-        bufid = (bufid + 1) % BUF_COUNT;
-        uint8_t *buf = (uint8_t *)(f.buf + f.pitch * f.pheight * bufid);
-        for (uint32_t y = 0; y < f.pheight; y++)
-        for (uint32_t x = 0; x < f.pwidth; x++) {
-            buf[y * f.pitch + x * 3 + 2] =
-            buf[y * f.pitch + x * 3 + 1] =
-            buf[y * f.pitch + x * 3 + 0] = 240;
-        }
-        print_init(buf, f.pwidth, f.pheight, f.pitch);
+        uint8_t id = swapchain_acquire_wait(&sc);
+        uint8_t *buf = fb_slice(id);
+        memset(buf, 240, f.pitch * f.pheight);
+        print_init(buf, f.pwidth, f.pheight, f.pitch, f.bpp);
         printf("\n%u application%s, %u gamepad%s\n------------\n\n",
             appcount, appcount == 1 ? "" : "s",
             count, count == 1 ? "" : "s");
         for (uint8_t i = 0; i != appcount; i++)
             printf("%c  %s\n", (i == selappidx ? '*' : ' '), appnames[i]);
-        set_virtual_offs(0, bufid * f.pheight);
-        for (uint32_t i = 0; i < 10000000; i++) __asm__ __volatile__ ("");
+        _clean_data_cache_range((uint32_t)buf, (uint32_t)buf + f.pitch * f.pheight);
+        DSB();
+        swapchain_present(&sc, id, dma_fence());
     } while (!selected);
 
     // Load selected application
-    // TODO: Directly load from file system to memory
-    uint8_t *start_file = (uint8_t *)0x5000000;
     snprintf(path_buf, sizeof path_buf, "/app/%s/start", appnames[selappidx]);
     FIL file;
     fr = f_open(&file, path_buf, FA_READ);
@@ -521,46 +706,153 @@ reselect:
         wait(3000000);
         goto reselect;
     }
-    UINT fsz = f_size(&file);
-    UINT bread;
-    f_read(&file, start_file, fsz, &bread);
-    f_close(&file);
-    printf("\nTotal %u (%u) bytes, ready to go\n", bread, fsz);
-    wait(3000000);
-
     // Set domain to 1
     // Set AP = 0b01 (privileged access only) (ARM ARM p. B4-9/B4-27)
     memcpy(mm_user, mm_sys, sizeof mm_user);
     mmu_table_section(mm_user, 0x20000000, 0x20000000, (1 << 5) | (1 << 10));
     mmu_table_section(mm_user, 0x20200000, 0x20200000, (1 << 5) | (1 << 10));
     // Open up enough space for user code
-    for (uint32_t i = 0x80000000; i < 0x90000000; i += 0x100000) {
-        mmu_table_section(mm_user, i, i - 0x80000000 + 0x1000000, 8 | 4);
+    for (uint32_t i = USER_BASE; i < USER_END; i += 0x100000) {
+        mmu_table_section(mm_user, i, i - USER_BASE + USER_PHYS_BASE, 8 | 4);
     }
+    // Framebuffer slices, so that the application can render in place
+    map_fb(true);
     _enable_mmu((uint32_t)mm_user);
-    // Client for domain 1, Manager for domain 0
 
-    load_elf(start_file);
-    const elf_ehdr *ehdr = (const elf_ehdr *)start_file;
+    // Segments are read from the file into the user region as mapped above
+    elf_reader reader = { elf_file_read, &file };
+    elf_addr entry;
+    uint8_t er = load_elf(&reader, &entry);
+    UINT fsz = f_size(&file);
+    f_close(&file);
+    if (er != ELF_E_NONE) {
+        _enable_mmu((uint32_t)mm_sys);
+        printf("\n\n! Cannot load %s: error %u\n", path_buf, er);
+        wait(3000000);
+        goto reselect;
+    }
+    printf("\nTotal %u bytes, ready to go\n", fsz);
+    struct disk_stats ds;
+    disk_cache_stats(&ds);
+    printf("Disk cache: %u hits, %u misses, %u reads, %u bytes\n",
+        ds.hits, ds.misses, ds.reads, ds.bytes);
+    wait(3000000);
 
+    // Client for domain 1, Manager for domain 0
     _set_domain_access((1 << 2) | 3);
     //_enter_user_mode();
-    _enter_user_code(ehdr->entry);
+    _enter_user_code(entry);
 
     _set_domain_access((3 << 2) | 3);
+    // Framebuffer writes from the launcher must not be evicted
+    // on top of what the DMA engine writes later
+    _clean_data_cache();
+    for (uint8_t i = 0; i < BUF_COUNT; i++)
+        damage_full(&slot_damage[i], f.pwidth, f.pheight);
+    uint32_t present_fence = dma_fence();
+    perf_reset();
     while (1) {
-        if (new_frame) {
-            // TODO: Optionally skip a frame
-            if (_update && _draw) {
-                //DMB();
-                //_set_domain_access((1 << 2) | 3);
-                (*_update)();
-                uint8_t *ret = (uint8_t *)(*_draw)();
-                //_set_domain_access((3 << 2) | 3);
-                emit_dma((void *)(f.buf + f.pitch * f.pheight * bufid),
-                    f.pitch, ret, f.pwidth * 3, f.pwidth * 3, f.pheight);
-                new_frame = false;
+        if (!_update || !_draw) continue;
+        uint32_t t0 = get_time();
+        if (swap_request >= 0) {
+            _disable_int();
+            swapchain_config(&sc, swap_request >> 8, swap_request & 0xff);
+            _enable_int();
+            swap_request = -1;
+        }
+        if (mode_request) apply_mode();
+        // One update() per tick elapsed since the last round
+        uint32_t updates = sched_wait(&sd);
+        // Usually immediate, as the same tick has flipped a buffer free
+        back_id = swapchain_acquire_wait(&sc);
+
+        // The application may touch its buffer from update() onwards;
+        // by now the last copy has usually long finished
+        wait_dma(present_fence);
+        uint32_t t1 = get_time();
+        perf_add(PERF_WAIT, t1 - t0);
+        //DMB();
+        //_set_domain_access((1 << 2) | 3);
+        while (updates-- > 0) (*_update)();
+        uint32_t t2 = get_time();
+        perf_add(PERF_UPDATE, t2 - t1);
+        if (!sched_draw(&sd)) {
+            // Behind schedule; damage reported so far is kept for
+            // the next frame that does get drawn
+            swapchain_cancel(&sc, back_id);
+            continue;
+        }
+        uint8_t *ret = (uint8_t *)(*_draw)();
+        //_set_domain_access((3 << 2) | 3);
+        uint32_t t3 = get_time();
+        perf_add(PERF_DRAW, t3 - t2);
+        if (!frame_damage_reported)
+            damage_full(&frame_damage, f.pwidth, f.pheight);
+        if (ret == user_fb(back_id)) {
+            // Rendered into the back buffer directly, only the
+            // cache needs to be written back before the flip
+            if (compose_blending()) {
+                struct rect all = { 0, 0, f.pwidth, f.pheight };
+                compose_blend(ret, f.pitch, fb_bypp(), &all, 1);
             }
+            _clean_data_cache_range((uint32_t)ret,
+                (uint32_t)ret + f.pitch * f.pheight);
+            DSB();
+            // Other slices no longer match the application's buffer
+            for (uint8_t i = 0; i < BUF_COUNT; i++)
+                damage_full(&slot_damage[i], f.pwidth, f.pheight);
+            damage_clear(&slot_damage[back_id]);
+        } else {
+            // This slice was last written a few frames ago and also
+            // needs everything damaged since then
+            struct damage *d = &slot_damage[back_id];
+            damage_merge(d, &frame_damage, f.pwidth, f.pheight);
+            uint8_t *slice = fb_slice(back_id);
+            // A background layer stands in for the application's buffer
+            const struct layer *bg = compose_get(0);
+            const uint8_t *base = (bg->mode != LAYER_OFF ? bg->buf : ret);
+            bool blend = compose_blending();
+            // Layers are blended over what the copy writes, so none of
+            // the old contents may linger in the cache
+            if (blend) slice_rects(slice, d->r, d->count, _flush_data_cache_range);
+            if (base != NULL) present_fence = emit_dma_rects(
+                slice, f.pitch,
+                (void *)base, f.pwidth * fb_bypp(), fb_bypp(), d->r, d->count);
+            if (blend) {
+                wait_dma(present_fence);
+                compose_blend(slice, f.pitch, fb_bypp(), d->r, d->count);
+                slice_rects(slice, d->r, d->count, _clean_data_cache_range);
+                DSB();
+            }
+            damage_clear(d);
+            for (uint8_t i = 0; i < BUF_COUNT; i++) if (i != back_id)
+                damage_merge(&slot_damage[i], &frame_damage, f.pwidth, f.pheight);
+        }
+        damage_clear(&frame_damage);
+        frame_damage_reported = false;
+        if (perf_hud_on) {
+            // Printed over the finished frame; the application's buffer
+            // does not have it, so every slice needs the area again
+            uint8_t *slice = fb_slice(back_id);
+            uint32_t hud_h = perf_hud_height(f.pheight);
+            wait_dma(present_fence);
+            // As for blending: lines cached before the copy are stale,
+            // and must not be written back over it
+            _flush_data_cache_range((uint32_t)slice, (uint32_t)slice + f.pitch * hud_h);
+            perf_hud(slice, f.pwidth, f.pheight, f.pitch, f.bpp);
+            _clean_data_cache_range((uint32_t)slice, (uint32_t)slice + f.pitch * hud_h);
+            DSB();
+            struct rect hud = { 0, 0, f.pwidth, hud_h };
+            for (uint8_t i = 0; i < BUF_COUNT; i++)
+                damage_add(&slot_damage[i], hud, f.pwidth, f.pheight);
         }
+        uint32_t t4 = get_time();
+        perf_add(PERF_PRESENT, t4 - t3);
+        perf_add(PERF_FRAME, t4 - t1);
+        // The flip waits for the fence
+        swapchain_present(&sc, back_id, present_fence);
+        // Files written during update() reach the card in what is
+        // otherwise spent waiting for the next tick
+        file_writeback();
     }
 }
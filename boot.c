@@ -1,3 +1,5 @@
+#include <string.h>
+
 extern unsigned char _bss_begin;
 extern unsigned char _bss_end;
 
@@ -8,11 +10,8 @@ extern void kernel_main();
 
 extern void kernel_startup()
 {
-    unsigned char *begin = &_bss_begin, *end = &_bss_end;
-    while (begin < end) *begin++ = 0;
-
-    begin = &_bss_dmem_begin, end = &_bss_dmem_end;
-    while (begin < end) *begin++ = 0;
+    memset(&_bss_begin, 0, &_bss_end - &_bss_begin);
+    memset(&_bss_dmem_begin, 0, &_bss_dmem_end - &_bss_dmem_begin);
 
     kernel_main();
 }
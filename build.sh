@@ -1,3 +1,3 @@
 #!/bin/sh
 make -C uspi/lib
-arm-none-eabi-gcc -mfpu=vfp -mfloat-abi=hard -march=armv6k -mtune=arm1176jzf-s -nostartfiles -Wl,-T,link.ld -I./uspi/include -std=c99 -O2 boot.S boot.c common.c print.c printf/printf.c sdcard/mylib.c sdcard/sdcard.c fatfs/ff.c fatfs/ffunicode.c ffdiskio.c user/elf/elf.c 1.c uspios.c uspi/lib/libuspi.a -o kernel.elf && arm-none-eabi-objcopy kernel.elf -O binary kernel.img
+arm-none-eabi-gcc -mfpu=vfp -mfloat-abi=hard -march=armv6k -mtune=arm1176jzf-s -nostartfiles -Wl,-T,link.ld -I./uspi/include -std=c99 -O2 boot.S boot.c mem.S membench.c common.c compose.c damage.c fb.c file.c perf.c sched.c swapchain.c print.c printf/printf.c sdcard/mylib.c sdcard/sdcard.c fatfs/ff.c fatfs/ffunicode.c ffdiskio.c user/elf/elf.c 1.c uspios.c uspi/lib/libuspi.a -o kernel.elf && arm-none-eabi-objcopy kernel.elf -O binary kernel.img
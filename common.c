@@ -84,38 +84,211 @@ void /*__attribute__((interrupt("IRQ")))*/ _int_irq()
     _set_domain_access((1 << 2) | 3);
 }
 
-uint8_t ___qwq___unused;
+uint32_t virt_to_bus(const void *p)
+{
+    uint32_t addr = (uint32_t)p;
+    if (addr >= USER_BASE && addr < USER_END)
+        addr = addr - USER_BASE + USER_PHYS_BASE;
+    // Uncached alias, the data cache is cleaned by hand
+    return addr | 0xc0000000;
+}
+
+struct dma_cb {
+    uint32_t ti;
+    uint32_t src;
+    uint32_t dst;
+    uint32_t len;
+    uint32_t stride;
+    uint32_t next;
+    uint32_t _reserved[2];
+} __attribute__((aligned(32)));
+
+#define DMA_MAX_CBS (DAMAGE_MAX * 2)
+
+static struct dma_cb present_cb[DMA_MAX_CBS]
+    __attribute__((section(".bss.dmem"), aligned(256)));
+
+// Number of transfers issued/completed; a fence is the value of
+// dma_issued right after the transfer is started
+static volatile uint32_t dma_issued = 0;
+static volatile uint32_t dma_done = 0;
+
+static void dma_handler(void *_unused)
+{
+    *DMA_CS(DMA_CH_PRESENT) = DMA_CS_INT | DMA_CS_END;
+    dma_done = dma_issued;
+}
+
+void dma_init()
+{
+    *DMA_ENABLE = (*DMA_ENABLE) | (1 << DMA_CH_PRESENT);
+    *DMA_CS(DMA_CH_PRESENT) = DMA_CS_RESET;
+    DMB(); DSB();
+    set_irq_handler(INT_IRQ_DMA(DMA_CH_PRESENT), dma_handler, NULL);
+
+    *DMA_ENABLE = (*DMA_ENABLE) | (1 << DMA_CH_FIFO);
+    *DMA_CS(DMA_CH_FIFO) = DMA_CS_RESET;
+    DMB(); DSB();
+}
+
+uint32_t dma_fence()
+{
+    return dma_issued;
+}
+
+bool dma_signalled(uint32_t fence)
+{
+    if ((int32_t)(dma_done - fence) >= 0) return true;
+    // A faulted transfer stops without raising its interrupt; drop it so
+    // that nothing waits forever, at the cost of a stale frame
+    if (*DMA_CS(DMA_CH_PRESENT) & DMA_CS_ERROR) {
+        *DMA_DEBUG(DMA_CH_PRESENT) = DMA_DEBUG_ERRORS;
+        *DMA_CS(DMA_CH_PRESENT) = DMA_CS_RESET;
+        DMB(); DSB();
+        dma_done = dma_issued;
+        return true;
+    }
+    return false;
+}
+
+void wait_dma(uint32_t fence)
+{
+    while (!dma_signalled(fence)) { }
+    DMB();
+}
+
+// Fills in a 2D control block, or copies with the CPU and returns false
+// if the transfer is out of range for the TXFR_LEN/STRIDE fields
+static bool dma_cb_2d(struct dma_cb *cb,
+    uint8_t *dst, uint32_t dpitch, uint8_t *src, uint32_t spitch,
+    uint32_t rowsize, uint32_t nrows)
+{
+    if (rowsize > 0xffff || nrows > 0x4000 ||
+        dpitch - rowsize > 0x7fff || spitch - rowsize > 0x7fff)
+    {
+        uint8_t *d = dst;
+        for (uint32_t i = 0; i < nrows; i++, d += dpitch, src += spitch)
+            memcpy(d, src, rowsize);
+        // The flip shows what is in memory, as with the engine's copy
+        _clean_data_cache_range((uint32_t)dst, (uint32_t)dst + dpitch * (nrows - 1) + rowsize);
+        DSB();
+        return false;
+    }
+
+    // The engine reads memory behind the data cache
+    _clean_data_cache_range((uint32_t)src, (uint32_t)src + spitch * (nrows - 1) + rowsize);
+
+    uint32_t ti = DMA_TI_TDMODE | DMA_TI_WAIT_RESP |
+        DMA_TI_SRC_INC | DMA_TI_DEST_INC | DMA_TI_BURST(8);
+    // 128-bit accesses if everything lines up
+    if ((((uint32_t)src | (uint32_t)dst | spitch | dpitch | rowsize) & 15) == 0)
+        ti |= DMA_TI_SRC_WIDTH | DMA_TI_DEST_WIDTH;
 
-void emit_dma(
+    cb->ti = ti;
+    cb->src = virt_to_bus(src);
+    cb->dst = (uint32_t)dst;
+    // YLENGTH + 1 rows are transferred in 2D mode (see errata)
+    cb->len = ((nrows - 1) << 16) | rowsize;
+    // Strides are applied at the end of each row
+    cb->stride = ((dpitch - rowsize) << 16) | (spitch - rowsize);
+    cb->next = 0;
+    return true;
+}
+
+static uint32_t dma_start_chain(uint32_t count)
+{
+    if (count == 0) return dma_issued;
+
+    // Only the last block raises the interrupt
+    for (uint32_t i = 0; i + 1 < count; i++)
+        present_cb[i].next = (uint32_t)&present_cb[i + 1] | 0xc0000000;
+    present_cb[count - 1].ti |= DMA_TI_INTEN;
+
+    uint32_t fence = dma_issued + 1;
+    DMB(); DSB();
+    dma_issued = fence;
+    *DMA_CS(DMA_CH_PRESENT) = DMA_CS_INT | DMA_CS_END;
+    *DMA_CBAD(DMA_CH_PRESENT) = (uint32_t)&present_cb[0] | 0xc0000000;
+    *DMA_CS(DMA_CH_PRESENT) = DMA_CS_ACTIVE;
+    DMB(); DSB();
+    return fence;
+}
+
+uint32_t emit_dma(
     void *dst, uint32_t dpitch, void *src, uint32_t spitch,
     uint32_t rowsize, uint32_t nrows)
 {
+    // Only one transfer in flight, the control blocks are reused
+    wait_dma(dma_issued);
+    if (nrows == 0 || rowsize == 0) return dma_issued;
+
+    if (!dma_cb_2d(&present_cb[0], dst, dpitch, src, spitch, rowsize, nrows))
+        return dma_issued;
+    return dma_start_chain(1);
+}
+
+static struct dma_cb fifo_cb __attribute__((section(".bss.dmem")));
+
+void dma_fifo_start(void *buf, uint32_t fifo, uint32_t len, uint8_t dreq, bool to_fifo)
+{
+    uint32_t start = (uint32_t)buf, end = start + len;
+    if (to_fifo) {
+        _clean_data_cache_range(start, end);
+        fifo_cb.ti = DMA_TI_SRC_INC | DMA_TI_DEST_DREQ;
+        fifo_cb.src = virt_to_bus(buf);
+        fifo_cb.dst = fifo;
+    } else {
+        // Nothing dirty may be evicted on top of what the engine writes,
+        // and nothing stale may be left to read afterwards
+        _flush_data_cache_range(start, end);
+        fifo_cb.ti = DMA_TI_DEST_INC | DMA_TI_SRC_DREQ;
+        fifo_cb.src = fifo;
+        fifo_cb.dst = virt_to_bus(buf);
+    }
+    fifo_cb.ti |= DMA_TI_WAIT_RESP | DMA_TI_PERMAP(dreq);
+    fifo_cb.len = len;
+    fifo_cb.stride = 0;
+    fifo_cb.next = 0;
+
+    DMB(); DSB();
+    *DMA_CS(DMA_CH_FIFO) = DMA_CS_INT | DMA_CS_END;
+    *DMA_CBAD(DMA_CH_FIFO) = (uint32_t)&fifo_cb | 0xc0000000;
+    *DMA_CS(DMA_CH_FIFO) = DMA_CS_ACTIVE;
     DMB(); DSB();
-    uint8_t *_dst = dst, *_src = src;
-    spitch = 256 * 3;
-    rowsize = 256 * 3;
-    nrows = 256;
-    // XXX: Manually cleaning data cache...
-    /*_clean_data_cache();
-    for (uint32_t i = 0; i < nrows; i++, _dst += dpitch, _src += spitch)
-        for (uint32_t j = 0; j < rowsize; j += 8) ___qwq___unused += _src[j];*/
-    for (uint32_t i = 0; i < nrows; i++, _dst += dpitch, _src += spitch)
-        for (uint32_t j = 0; j < rowsize; j++) _dst[j] = _src[j];
-    return;
-    src = (void *)(((uint32_t)src - 0x80000000 + 0x1000000) | 0xc0000000);
-    dpitch -= rowsize;
-    spitch -= rowsize;
-    *DMA_ENABLE = (*DMA_ENABLE) | 2;
-    *DMA_1_CS = (1 << 31);
-    static uint32_t cblk[8] __attribute__((section(".bss.dmem"), aligned(256)));
-    cblk[0] = (1 << 8) | (1 << 4) | (1 << 1);
-    cblk[1] = (uint32_t)src;
-    cblk[2] = (uint32_t)dst;
-    cblk[3] = ((nrows << 16) | rowsize);
-    cblk[4] = ((dpitch << 16) | spitch);
-    cblk[5] = 0;
-    cblk[6] = cblk[7] = 0;
-    *DMA_1_CBAD = (uint32_t)cblk | 0xc0000000;
-    *DMA_1_CS = 1;
+}
+
+int32_t dma_fifo_poll()
+{
+    uint32_t cs = *DMA_CS(DMA_CH_FIFO);
+    DMB();
+    if (cs & DMA_CS_ERROR) return -1;
+    return (cs & DMA_CS_END) ? 0 : 1;
+}
+
+void dma_fifo_abort()
+{
+    // The error bit stays up until the debug flags behind it are cleared
+    *DMA_DEBUG(DMA_CH_FIFO) = DMA_DEBUG_ERRORS;
+    *DMA_CS(DMA_CH_FIFO) = DMA_CS_RESET;
     DMB(); DSB();
 }
+
+uint32_t emit_dma_rects(
+    void *dst, uint32_t dpitch, void *src, uint32_t spitch,
+    uint32_t bypp, const struct rect *r, uint32_t count)
+{
+    wait_dma(dma_issued);
+
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < count && n < DMA_MAX_CBS; i++) {
+        if (r[i].w == 0 || r[i].h == 0) continue;
+        if (dma_cb_2d(&present_cb[n],
+            (uint8_t *)dst + r[i].y * dpitch + r[i].x * bypp, dpitch,
+            (uint8_t *)src + r[i].y * spitch + r[i].x * bypp, spitch,
+            r[i].w * bypp, r[i].h))
+        {
+            n++;
+        }
+    }
+    return dma_start_chain(n);
+}
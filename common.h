@@ -10,6 +10,8 @@
 #include "uspios.h"
 #include "sdcard/sdcard.h"
 #include "fatfs/ff.h"
+#include "damage.h"
+#include "dma_fifo.h"
 
 #define GPIO_BASE   0x20200000
 
@@ -57,16 +59,71 @@
 #define DMA_0_CBAD  (volatile uint32_t *)(DMA_BASE + 0x4)
 #define DMA_1_CS    (volatile uint32_t *)(DMA_BASE + 0x100)
 #define DMA_1_CBAD  (volatile uint32_t *)(DMA_BASE + 0x104)
+#define DMA_CS(__ch)    (volatile uint32_t *)(DMA_BASE + (__ch) * 0x100 + 0x0)
+#define DMA_CBAD(__ch)  (volatile uint32_t *)(DMA_BASE + (__ch) * 0x100 + 0x4)
+#define DMA_DEBUG(__ch) (volatile uint32_t *)(DMA_BASE + (__ch) * 0x100 + 0x20)
+#define DMA_INT_STATUS  (volatile uint32_t *)(DMA_BASE + 0xfe0)
 #define DMA_ENABLE  (volatile uint32_t *)(DMA_BASE + 0xff0)
 
+// Control/status bits (BCM2835 ARM Peripherals p. 47)
+#define DMA_CS_ACTIVE   (1 << 0)
+#define DMA_CS_END      (1 << 1)
+#define DMA_CS_INT      (1 << 2)
+#define DMA_CS_ERROR    (1 << 8)
+#define DMA_CS_ABORT    (1 << 30)
+#define DMA_CS_RESET    (1u << 31)
+
+// Debug register error bits, written with 1 to clear (p. 55)
+#define DMA_DEBUG_ERRORS    0x7
+
+// Transfer information bits (p. 50)
+#define DMA_TI_INTEN        (1 << 0)
+#define DMA_TI_TDMODE       (1 << 1)
+#define DMA_TI_WAIT_RESP    (1 << 3)
+#define DMA_TI_DEST_INC     (1 << 4)
+#define DMA_TI_DEST_WIDTH   (1 << 5)
+#define DMA_TI_DEST_DREQ    (1 << 6)
+#define DMA_TI_SRC_INC      (1 << 8)
+#define DMA_TI_SRC_WIDTH    (1 << 9)
+#define DMA_TI_SRC_DREQ     (1 << 10)
+#define DMA_TI_BURST(__n)   ((__n) << 12)
+#define DMA_TI_PERMAP(__n)  ((__n) << 16)
+
+// Channels 0~6 are full channels that support 2D mode. The firmware
+// keeps 1, 3, 6 and 7 for itself (its dma.dmachans mask, 0x7f35 by
+// default, lists the ones left to us); both picks are in that mask
+#define DMA_CH_PRESENT  0
+#define DMA_CH_FIFO     4
+
+// DMA channel n raises IRQ 16 + n
+#define INT_IRQ_DMA(__ch)   (16 + (__ch))
+
+// Application memory, see the mm_user set-up in kernel_main()
+#define USER_BASE       0x80000000
+#define USER_END        0x90000000
+#define USER_PHYS_BASE  0x1000000
+// Whether [p, p + len) lies in application memory; written so that
+// nothing can wrap around
+static inline bool user_range(uint32_t p, uint64_t len)
+{
+    return (p >= USER_BASE && p < USER_END && len <= USER_END - p);
+}
+// Framebuffer slices as seen by the application
+#define USER_FB_BASE    0x90000000
+
 #define DMB() __asm__ __volatile__ ("mcr p15, 0, %0, c7, c10, 5" : : "r" (0) : "memory")
 #define DSB() __asm__ __volatile__ ("mcr p15, 0, %0, c7, c10, 4" : : "r" (0) : "memory")
 
 void _enable_int();
+void _disable_int();
 void _enable_mmu(uint32_t table_base_addr);
 void _set_domain_access(uint32_t control);
 void _flush_mmu_table();
 void _clean_data_cache();
+// Operates on the cache lines covering [start, end)
+void _clean_data_cache_range(uint32_t start, uint32_t end);
+// Also drops the lines, so that the next reads see what DMA has written
+void _flush_data_cache_range(uint32_t start, uint32_t end);
 void _standby();
 uint32_t _get_mode();
 void _enter_user_mode();
@@ -81,6 +138,9 @@ void set_irq_handler(uint8_t source, irq_handler f, void *arg);
 
 void uspios_init();
 
+// Prints the throughput of memcpy/memmove/memset; with -DMEM_BENCH only
+void mem_bench();
+
 // Single tag at a time
 
 #define mbox_buf(__sz) \
@@ -116,8 +176,35 @@ void uspios_init();
 void send_mail(uint32_t data, uint8_t channel);
 uint32_t recv_mail(uint8_t channel);
 
-void emit_dma(
+uint32_t virt_to_bus(const void *p);
+
+// Starts a 2D copy of nrows rows, rowsize bytes each, and returns immediately.
+// dst is expected to be a framebuffer (bus) address, src any mapped address.
+// The returned fence is signalled by the completion interrupt.
+void dma_init();
+uint32_t emit_dma(
     void *dst, uint32_t dpitch, void *src, uint32_t spitch,
     uint32_t rowsize, uint32_t nrows);
+// Same as above for a list of rectangles, in pixels of bypp bytes
+uint32_t emit_dma_rects(
+    void *dst, uint32_t dpitch, void *src, uint32_t spitch,
+    uint32_t bypp, const struct rect *r, uint32_t count);
+// Fence of the latest transfer
+uint32_t dma_fence();
+bool dma_signalled(uint32_t fence);
+void wait_dma(uint32_t fence);
+
+// Sector cache of ffdiskio.c, counted since mount; hits and misses are
+// in sectors, reads, writes and errors in card commands, bytes and
+// written as transferred to or from the card
+struct disk_stats {
+    uint32_t hits, misses;
+    uint32_t reads, bytes;
+    uint32_t writes, written;
+    uint32_t errors;
+};
+void disk_cache_stats(struct disk_stats *s);
+// Writes out the sectors held back by the cache; nonzero on error
+int32_t disk_flush();
 
 #endif
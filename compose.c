@@ -0,0 +1,101 @@
+#include "compose.h"
+#include "common.h"
+#include "user/pix/pix.h"
+
+static struct layer layers[COMPOSE_LAYERS];
+// One row of a fill layer's colour, blended like pixels of a buffer
+static uint8_t fill_row[1920 * 4 + 4] __attribute__((aligned(4)));
+
+void compose_reset()
+{
+    memset(layers, 0, sizeof layers);
+}
+
+void compose_set(uint8_t index, const struct layer *l)
+{
+    if (index >= COMPOSE_LAYERS) return;
+    if (l) layers[index] = *l;
+    else layers[index].mode = LAYER_OFF;
+}
+
+const struct layer *compose_get(uint8_t index)
+{
+    return (index < COMPOSE_LAYERS ? &layers[index] : NULL);
+}
+
+bool compose_blending()
+{
+    for (uint8_t i = 1; i < COMPOSE_LAYERS; i++)
+        if (layers[i].mode != LAYER_OFF) return true;
+    return false;
+}
+
+static inline bool intersect(struct rect a, struct rect b, struct rect *o)
+{
+    uint16_t x0 = (a.x > b.x ? a.x : b.x);
+    uint16_t y0 = (a.y > b.y ? a.y : b.y);
+    uint16_t x1 = (a.x + a.w < b.x + b.w ? a.x + a.w : b.x + b.w);
+    uint16_t y1 = (a.y + a.h < b.y + b.h ? a.y + a.h : b.y + b.h);
+    if (x0 >= x1 || y0 >= y1) return false;
+    *o = (struct rect){ x0, y0, x1 - x0, y1 - y0 };
+    return true;
+}
+
+static void blend_rows(uint8_t *d, uint32_t dpitch, const struct layer *l,
+    struct rect r, uint32_t bypp)
+{
+    const uint8_t *s = (l->buf ?
+        l->buf + (r.y - l->r.y) * l->pitch + (r.x - l->r.x) * bypp : NULL);
+    uint32_t rowsize = r.w * bypp;
+    uint16_t a = l->alpha;
+
+    if (l->mode == LAYER_FILL && bypp != 2) {
+        // Same alignment as the destination, so that whole words are blended
+        uint8_t *p = fill_row + ((uint32_t)d & 3);
+        if (bypp == 3) pix_fill24(p, r.w, l->key);
+        else pix_fill32((uint32_t *)p, r.w, l->key);
+        s = p;
+    }
+
+    for (uint16_t y = 0; y < r.h; y++, d += dpitch) {
+        switch (l->mode) {
+        case LAYER_OPAQUE:
+            memcpy(d, s, rowsize);
+            break;
+        case LAYER_KEY:
+            if (bypp == 2) pix_key16((uint16_t *)d, (const uint16_t *)s, r.w, l->key);
+            else if (bypp == 3) pix_key24(d, s, r.w, l->key);
+            else pix_key32((uint32_t *)d, (const uint32_t *)s, r.w, l->key);
+            break;
+        case LAYER_ALPHA:
+        case LAYER_FILL:
+            if (bypp == 2) {
+                for (uint16_t x = 0; x < r.w; x++)
+                    ((uint16_t *)d)[x] = pix_blend565(((uint16_t *)d)[x],
+                        (s ? ((const uint16_t *)s)[x] : (uint16_t)l->key), a);
+            } else {
+                pix_blend(d, s, rowsize, a);
+            }
+            break;
+        default:
+            break;
+        }
+        // A fill keeps blending the same row
+        if (l->mode != LAYER_FILL) s += l->pitch;
+    }
+}
+
+void compose_blend(
+    uint8_t *dst, uint32_t pitch, uint32_t bypp,
+    const struct rect *r, uint32_t count)
+{
+    for (uint8_t i = 1; i < COMPOSE_LAYERS; i++) {
+        const struct layer *l = &layers[i];
+        if (l->mode == LAYER_OFF) continue;
+        for (uint32_t j = 0; j < count; j++) {
+            struct rect o;
+            if (intersect(r[j], l->r, &o))
+                blend_rows(dst + o.y * pitch + o.x * bypp, pitch, l, o, bypp);
+        }
+    }
+}
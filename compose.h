@@ -0,0 +1,50 @@
+#ifndef __MIKAN__COMPOSE_H__
+#define __MIKAN__COMPOSE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "damage.h"
+
+// Layers composited by the kernel while presenting a frame.
+// Layer 0 is a static, full-screen background that replaces the buffer
+// returned by draw() and is copied by DMA only where damaged; the others
+// are blended on top of it by the CPU, within their rectangles only.
+
+#define COMPOSE_LAYERS  4
+
+#define LAYER_OFF       0
+#define LAYER_OPAQUE    1
+#define LAYER_KEY       2   // Pixels equal to the key are left out
+#define LAYER_ALPHA     3   // Constant alpha
+#define LAYER_FILL      4   // No pixels; the key colour at constant alpha
+
+// As passed by applications
+struct layer_desc {
+    const void *pixels;     // w * h pixels at the current depth, rows packed
+    uint16_t x, y, w, h;
+    uint8_t mode;
+    uint8_t alpha;          // 0 ~ 255
+    uint32_t key;
+};
+
+struct layer {
+    uint8_t mode;
+    uint16_t alpha;         // 0 ~ 256
+    uint32_t key;           // A pixel value at the current depth
+    struct rect r;          // On screen, clipped
+    const uint8_t *buf;     // Top-left pixel of r
+    uint32_t pitch;
+};
+
+void compose_reset();
+void compose_set(uint8_t index, const struct layer *l);
+const struct layer *compose_get(uint8_t index);
+// Whether any layer needs to be blended by the CPU
+bool compose_blending();
+
+// Blends layers 1 and above over the given regions of a frame
+void compose_blend(
+    uint8_t *dst, uint32_t pitch, uint32_t bypp,
+    const struct rect *r, uint32_t count);
+
+#endif
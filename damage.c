@@ -0,0 +1,54 @@
+#include "damage.h"
+
+static inline bool contains(const struct rect *a, const struct rect *b)
+{
+    return a->x <= b->x && a->y <= b->y &&
+        a->x + a->w >= b->x + b->w && a->y + a->h >= b->y + b->h;
+}
+
+void damage_clear(struct damage *d)
+{
+    d->count = 0;
+}
+
+void damage_full(struct damage *d, uint16_t w, uint16_t h)
+{
+    d->count = 1;
+    d->r[0] = (struct rect){ 0, 0, w, h };
+}
+
+void damage_add(struct damage *d, struct rect r, uint16_t w, uint16_t h)
+{
+    if (r.x >= w || r.y >= h) return;
+    if (r.w > w - r.x) r.w = w - r.x;
+    if (r.h > h - r.y) r.h = h - r.y;
+    if (r.w == 0 || r.h == 0) return;
+
+    // Drop rectangles covered by the new one, or the new one if covered
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < d->count; i++) {
+        if (contains(&d->r[i], &r)) return;
+        if (!contains(&r, &d->r[i])) d->r[n++] = d->r[i];
+    }
+    d->count = n;
+
+    if (d->count < DAMAGE_MAX) {
+        d->r[d->count++] = r;
+        return;
+    }
+
+    uint16_t x1 = r.x, y1 = r.y, x2 = r.x + r.w, y2 = r.y + r.h;
+    for (uint8_t i = 0; i < d->count; i++) {
+        if (x1 > d->r[i].x) x1 = d->r[i].x;
+        if (y1 > d->r[i].y) y1 = d->r[i].y;
+        if (x2 < d->r[i].x + d->r[i].w) x2 = d->r[i].x + d->r[i].w;
+        if (y2 < d->r[i].y + d->r[i].h) y2 = d->r[i].y + d->r[i].h;
+    }
+    d->count = 1;
+    d->r[0] = (struct rect){ x1, y1, x2 - x1, y2 - y1 };
+}
+
+void damage_merge(struct damage *d, const struct damage *s, uint16_t w, uint16_t h)
+{
+    for (uint8_t i = 0; i < s->count; i++) damage_add(d, s->r[i], w, h);
+}
@@ -0,0 +1,26 @@
+#ifndef __MIKAN__DAMAGE_H__
+#define __MIKAN__DAMAGE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Rectangle lists describing the regions of a frame that have changed
+
+#define DAMAGE_MAX  16
+
+struct rect {
+    uint16_t x, y, w, h;
+};
+
+struct damage {
+    uint8_t count;
+    struct rect r[DAMAGE_MAX];
+};
+
+void damage_clear(struct damage *d);
+void damage_full(struct damage *d, uint16_t w, uint16_t h);
+// Clips against (w, h); collapses into the bounding box when out of slots
+void damage_add(struct damage *d, struct rect r, uint16_t w, uint16_t h);
+void damage_merge(struct damage *d, const struct damage *s, uint16_t w, uint16_t h);
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef __MIKAN__DMA_FIFO_H__
+#define __MIKAN__DMA_FIFO_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Transfers between memory and a peripheral's FIFO register, paced by
+// the peripheral, on a DMA channel of their own (common.c)
+
+// Peripheral DREQ lines (BCM2835 ARM Peripherals p. 61)
+#define DMA_DREQ_EMMC   11
+
+// Starts moving len bytes between buf and the peripheral FIFO register at
+// bus address fifo, a word each time the peripheral raises DREQ line dreq.
+// buf is word-aligned; for reads, it should also cover whole cache lines,
+// and is not to be touched until the transfer is over.
+void dma_fifo_start(void *buf, uint32_t fifo, uint32_t len, uint8_t dreq, bool to_fifo);
+// 1 while running, 0 when done, -1 on an error
+int32_t dma_fifo_poll();
+void dma_fifo_abort();
+
+#endif
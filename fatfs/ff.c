@@ -21,6 +21,7 @@
 
 #include "ff.h"			/* Declarations of FatFs API */
 #include "diskio.h"		/* Declarations of device I/O functions */
+#include <string.h>		/* memcpy/memset, provided by the kernel (mem.S) */
 
 
 /*--------------------------------------------------------------------------
@@ -683,25 +684,14 @@ static void st_qword (BYTE* ptr, QWORD val)	/* Store an 8-byte word in little-en
 /* Copy memory to memory */
 static void mem_cpy (void* dst, const void* src, UINT cnt)
 {
-	BYTE *d = (BYTE*)dst;
-	const BYTE *s = (const BYTE*)src;
-
-	if (cnt != 0) {
-		do {
-			*d++ = *s++;
-		} while (--cnt);
-	}
+	memcpy(dst, src, cnt);
 }
 
 
 /* Fill memory block */
 static void mem_set (void* dst, int val, UINT cnt)
 {
-	BYTE *d = (BYTE*)dst;
-
-	do {
-		*d++ = (BYTE)val;
-	} while (--cnt);
+	memset(dst, val, cnt);
 }
 
 
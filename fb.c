@@ -0,0 +1,98 @@
+#include "fb.h"
+#include "common.h"
+
+struct fb f;
+uint32_t display_w = 0, display_h = 0;
+
+static void get_display_size()
+{
+    static mbox_buf(8) buf __attribute__((section(".bss.dmem"), aligned(16)));
+    mbox_init(buf);
+    buf.tag.id = 0x40003;   // Get physical (display) width/height
+    mbox_emit(buf);
+    display_w = buf.tag.u32[0];
+    display_h = buf.tag.u32[1];
+}
+
+// Borders around the scaled picture, in display pixels, so that the
+// scaler keeps the aspect ratio instead of stretching to the screen
+static void letterbox(uint32_t w, uint32_t h)
+{
+    uint32_t t = 0, l = 0;
+    if (display_w != 0 && display_h != 0) {
+        if (w * display_h > h * display_w)
+            t = (display_h - h * display_w / w) / 2;
+        else
+            l = (display_w - w * display_h / h) / 2;
+    }
+    set_overscan(t, t, l, l);
+}
+
+bool fb_alloc(uint32_t w, uint32_t h, uint32_t bpp, uint32_t count)
+{
+    // Once allocated, the firmware reports our own size instead
+    if (display_w == 0) get_display_size();
+    letterbox(w, h);
+
+    static struct fb f_volatile __attribute__((section(".bss.dmem"), aligned(16)));
+    memset((void *)&f_volatile, 0, sizeof f_volatile);
+    f_volatile.pwidth = w;
+    f_volatile.pheight = h;
+    f_volatile.vwidth = w;
+    f_volatile.vheight = h * count;
+    f_volatile.bpp = bpp;
+    DSB();
+    send_mail(((uint32_t)&f_volatile + 0x40000000) >> 4, MAIL0_CH_FB);
+    uint32_t ret = recv_mail(MAIL0_CH_FB);
+    DMB();
+
+    // The firmware may round the request or refuse it altogether
+    if (ret != 0 || f_volatile.buf == 0 ||
+        f_volatile.pwidth != w || f_volatile.pheight != h ||
+        f_volatile.bpp != bpp)
+        return false;
+    f = f_volatile;
+    return true;
+}
+
+uint32_t set_pixel_order(uint32_t val)
+{
+    static mbox_buf(4) buf __attribute__((section(".bss.dmem"), aligned(16)));
+    mbox_init(buf);
+    buf.tag.id = 0x00048006;   // Set pixel order
+    buf.tag.u32[0] = val;
+    mbox_emit(buf);
+    return buf.tag.u32[0];
+}
+
+uint32_t get_pixel_order()
+{
+    static mbox_buf(4) buf __attribute__((section(".bss.dmem"), aligned(16)));
+    mbox_init(buf);
+    buf.tag.id = 0x40006;   // Get pixel order
+    buf.tag.u32[0] = 123;
+    mbox_emit(buf);
+    return buf.tag.u32[0];
+}
+
+void set_overscan(uint32_t top, uint32_t bottom, uint32_t left, uint32_t right)
+{
+    static mbox_buf(16) buf __attribute__((section(".bss.dmem"), aligned(16)));
+    mbox_init(buf);
+    buf.tag.id = 0x4800a;   // Set overscan
+    buf.tag.u32[0] = top;
+    buf.tag.u32[1] = bottom;
+    buf.tag.u32[2] = left;
+    buf.tag.u32[3] = right;
+    mbox_emit(buf);
+}
+
+void set_virtual_offs(uint32_t x, uint32_t y)
+{
+    static mbox_buf(8) buf __attribute__((section(".bss.dmem"), aligned(16)));
+    mbox_init(buf);
+    buf.tag.id = 0x48009;   // Set virtual offset
+    buf.tag.u32[0] = x;
+    buf.tag.u32[1] = y;
+    mbox_emit(buf);
+}
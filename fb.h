@@ -0,0 +1,47 @@
+#ifndef __MIKAN__FB_H__
+#define __MIKAN__FB_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Framebuffer allocated by the VideoCore, as exchanged through the
+// mailbox framebuffer channel. Slices of pheight rows are stacked
+// vertically and flipped between by moving the virtual offset.
+// The "physical" size is what the scaler stretches over the display,
+// so applications render at their own size and the upscale is free.
+struct fb {
+    uint32_t pwidth;
+    uint32_t pheight;
+    uint32_t vwidth;
+    uint32_t vheight;
+    uint32_t pitch;
+    uint32_t bpp;
+    uint32_t xoffs;
+    uint32_t yoffs;
+    uint32_t buf;
+    uint32_t size;
+};
+
+extern struct fb f;
+
+#define FB_ORDER_BGR    0
+#define FB_ORDER_RGB    1
+
+// Size of the attached display, as found before the first allocation
+extern uint32_t display_w, display_h;
+
+// Allocates count slices of w * h pixels, letterboxed to keep their
+// aspect ratio on the display; f is left untouched on failure
+bool fb_alloc(uint32_t w, uint32_t h, uint32_t bpp, uint32_t count);
+static inline uint32_t fb_bypp() { return f.bpp / 8; }
+static inline uint8_t *fb_slice(uint8_t id)
+{
+    return (uint8_t *)(f.buf + f.pitch * f.pheight * id);
+}
+
+uint32_t set_pixel_order(uint32_t val);
+uint32_t get_pixel_order();
+void set_virtual_offs(uint32_t x, uint32_t y);
+void set_overscan(uint32_t top, uint32_t bottom, uint32_t left, uint32_t right);
+
+#endif
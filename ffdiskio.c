@@ -2,6 +2,185 @@
 #include "fatfs/diskio.h"
 #include "common.h"
 
+// Sector cache between FatFs and the card: hashed by sector number,
+// evicted least recently used first. A read that continues the previous
+// one is taken as sequential and fetches DISK_READAHEAD more sectors in
+// the same command. Runs of DISK_DIRECT or more missing sectors are read
+// straight into the caller's buffer instead: whole sectors of f_read()
+// land in the application's memory without a copy, and streaming a file
+// does not flush the cache.
+//
+// Writes are held back in the cache as dirty blocks, up to
+// DISK_WRITEBACK of them, and go out sorted, adjacent sectors in one
+// command, on CTRL_SYNC or disk_flush(). Runs of DISK_READAHEAD or more
+// sectors are written straight from the caller's buffer.
+
+#define DISK_CACHE_BLOCKS   256     // 128 KiB
+#define DISK_CACHE_BUCKETS  64
+#define DISK_READAHEAD      32
+#define DISK_DIRECT         4
+#define DISK_WRITEBACK      32
+
+#define SS  FF_MIN_SS
+
+struct cache_block {
+    LBA_t sector;           // DISK_NONE if unused
+    int16_t hnext;          // In the same bucket
+    int16_t prev, next;     // In the LRU list, most recent first
+    bool dirty;             // Newer than the card
+};
+
+#define DISK_NONE   ((LBA_t)-1)
+
+static struct cache_block blocks[DISK_CACHE_BLOCKS];
+static int16_t bucket[DISK_CACHE_BUCKETS];
+static int16_t lru_head, lru_tail;
+static uint8_t block_data[DISK_CACHE_BLOCKS][SS] __attribute__((aligned(32)));
+
+// Multi-block reads land here, then are copied out
+static uint8_t stage[DISK_READAHEAD][SS] __attribute__((aligned(32)));
+// Dirty blocks are gathered here to be written together
+static uint8_t wstage[DISK_WRITEBACK][SS] __attribute__((aligned(32)));
+static uint32_t dirty_count;
+
+static LBA_t seq_next = DISK_NONE;
+static struct disk_stats stats;
+
+static inline uint32_t hash(LBA_t sector)
+{
+    return (uint32_t)sector & (DISK_CACHE_BUCKETS - 1);
+}
+
+static void cache_init()
+{
+    for (int16_t i = 0; i < DISK_CACHE_BLOCKS; i++) {
+        blocks[i].sector = DISK_NONE;
+        blocks[i].hnext = -1;
+        blocks[i].dirty = false;
+        blocks[i].prev = i - 1;
+        blocks[i].next = (i + 1 < DISK_CACHE_BLOCKS ? i + 1 : -1);
+    }
+    lru_head = 0;
+    lru_tail = DISK_CACHE_BLOCKS - 1;
+    for (uint32_t i = 0; i < DISK_CACHE_BUCKETS; i++) bucket[i] = -1;
+    seq_next = DISK_NONE;
+    dirty_count = 0;
+    memset(&stats, 0, sizeof stats);
+}
+
+static int16_t lookup(LBA_t sector)
+{
+    int16_t i = bucket[hash(sector)];
+    while (i >= 0 && blocks[i].sector != sector) i = blocks[i].hnext;
+    return i;
+}
+
+// Moves to the front of the LRU list
+static void touch(int16_t i)
+{
+    if (i == lru_head) return;
+    struct cache_block *b = &blocks[i];
+    blocks[b->prev].next = b->next;
+    if (b->next >= 0) blocks[b->next].prev = b->prev;
+    else lru_tail = b->prev;
+    b->prev = -1;
+    b->next = lru_head;
+    blocks[lru_head].prev = i;
+    lru_head = i;
+}
+
+static void unhash(int16_t i)
+{
+    int16_t *p = &bucket[hash(blocks[i].sector)];
+    while (*p != i) p = &blocks[*p].hnext;
+    *p = blocks[i].hnext;
+}
+
+static int32_t card_read(BYTE *buff, LBA_t sector, UINT count)
+{
+    stats.reads++;
+    int32_t ret = sdTransferBlocks((uint64_t)sector * SS, count, buff, 0);
+    if (ret == 0) stats.bytes += count * SS;
+    else stats.errors++;
+    return ret;
+}
+
+static int32_t card_write(const BYTE *buff, LBA_t sector, UINT count)
+{
+    stats.writes++;
+    int32_t ret = sdTransferBlocks((uint64_t)sector * SS, count, (unsigned char *)buff, 1);
+    if (ret == 0) stats.written += count * SS;
+    else stats.errors++;
+    return ret;
+}
+
+static inline void clean(int16_t i)
+{
+    if (blocks[i].dirty) {
+        blocks[i].dirty = false;
+        dirty_count--;
+    }
+}
+
+int32_t disk_flush()
+{
+    if (dirty_count == 0) return 0;
+
+    // Sorted by sector; few enough for an insertion sort
+    int16_t list[DISK_WRITEBACK];
+    uint32_t n = 0;
+    for (int16_t i = 0; i < DISK_CACHE_BLOCKS; i++) {
+        if (!blocks[i].dirty) continue;
+        uint32_t k = n++;
+        for (; k > 0 && blocks[list[k - 1]].sector > blocks[i].sector; k--)
+            list[k] = list[k - 1];
+        list[k] = i;
+    }
+
+    for (uint32_t i = 0; i < n; ) {
+        LBA_t sector = blocks[list[i]].sector;
+        uint32_t run = 1;
+        while (i + run < n && blocks[list[i + run]].sector == sector + run) run++;
+        const uint8_t *src = block_data[list[i]];
+        if (run > 1) {
+            for (uint32_t k = 0; k < run; k++)
+                memcpy(wstage[k], block_data[list[i + k]], SS);
+            src = wstage[0];
+        }
+        if (card_write(src, sector, run) != 0) return -1;
+        for (uint32_t k = 0; k < run; k++) clean(list[i + k]);
+        i += run;
+    }
+    return 0;
+}
+
+// Takes over the least recently used block, writing it out first if
+// needed; -1 on error
+static int16_t claim(LBA_t sector)
+{
+    int16_t i = lru_tail;
+    if (blocks[i].dirty && disk_flush() != 0) return -1;
+    if (blocks[i].sector != DISK_NONE) unhash(i);
+    blocks[i].sector = sector;
+    blocks[i].hnext = bucket[hash(sector)];
+    bucket[hash(sector)] = i;
+    touch(i);
+    return i;
+}
+
+static bool insert(LBA_t sector, const uint8_t *data)
+{
+    int16_t i = claim(sector);
+    if (i < 0) return false;
+    memcpy(block_data[i], data, SS);
+    return true;
+}
+
+void disk_cache_stats(struct disk_stats *s)
+{
+    *s = stats;
+}
+
 DSTATUS disk_status(BYTE pdrv)
 {
     return 0;
@@ -11,11 +190,83 @@ DSTATUS disk_initialize(BYTE pdrv)
 {
     // Initialization could also be done here
     // instead of in kernel_main()
+    cache_init();
     return 0;
 }
 
 DRESULT disk_read(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count)
 {
-    int32_t ret = sdTransferBlocks((uint64_t)sector * FF_MIN_SS, count, buff, 0);
-    return (ret == 0 ? RES_OK : RES_ERROR);
+    bool seq = (sector == seq_next);
+    seq_next = sector + count;
+
+    for (UINT i = 0; i < count; ) {
+        int16_t b = lookup(sector + i);
+        if (b >= 0) {
+            memcpy(buff + i * SS, block_data[b], SS);
+            touch(b);
+            stats.hits++;
+            i++;
+            continue;
+        }
+
+        // Sectors missing from here on
+        UINT n = 1;
+        while (i + n < count && lookup(sector + i + n) < 0) n++;
+        stats.misses += n;
+        if (n >= DISK_DIRECT) {
+            if (card_read(buff + i * SS, sector + i, n) != 0) return RES_ERROR;
+            i += n;
+            continue;
+        }
+
+        // Past the end of the card, the longer read fails; retry as asked
+        UINT total = (seq ? DISK_READAHEAD : n);
+        if (card_read(stage[0], sector + i, total) != 0 &&
+            (total == n || card_read(stage[0], sector + i, total = n) != 0))
+            return RES_ERROR;
+        memcpy(buff + i * SS, stage[0], n * SS);
+        // Making room may write out and evict a dirty block among the
+        // sectors read ahead, whose copy in stage is then stale
+        uint32_t writes = stats.writes;
+        for (UINT k = 0; k < total; k++) {
+            if (k >= n && (stats.writes != writes || lookup(sector + i + k) >= 0)) continue;
+            if (!insert(sector + i + k, stage[k])) return RES_ERROR;
+        }
+        i += n;
+    }
+    return RES_OK;
+}
+
+DRESULT disk_write(BYTE pdrv, const BYTE *buff, LBA_t sector, UINT count)
+{
+    if (count >= DISK_READAHEAD) {
+        if (card_write(buff, sector, count) != 0) return RES_ERROR;
+        // Cached copies, held back or not, are now older than the card
+        for (UINT i = 0; i < count; i++) {
+            int16_t b = lookup(sector + i);
+            if (b < 0) continue;
+            memcpy(block_data[b], buff + i * SS, SS);
+            clean(b);
+        }
+        return RES_OK;
+    }
+
+    for (UINT i = 0; i < count; i++) {
+        int16_t b = lookup(sector + i);
+        if (b < 0 || !blocks[b].dirty) {
+            if (dirty_count == DISK_WRITEBACK && disk_flush() != 0) return RES_ERROR;
+            if (b < 0 && (b = claim(sector + i)) < 0) return RES_ERROR;
+            blocks[b].dirty = true;
+            dirty_count++;
+        }
+        memcpy(block_data[b], buff + i * SS, SS);
+        touch(b);
+    }
+    return RES_OK;
+}
+
+DRESULT disk_ioctl(BYTE pdrv, BYTE cmd, void *buff)
+{
+    if (cmd == CTRL_SYNC) return (disk_flush() == 0 ? RES_OK : RES_ERROR);
+    return RES_PARERR;
 }
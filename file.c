@@ -0,0 +1,202 @@
+#include "file.h"
+#include "common.h"
+
+#define PATH_MAX    (FF_LFN_BUF * 2 + 10)
+
+#if FF_LFN_BUF >= FILE_NAME_MAX
+#error "file_info name too short for FF_LFN_BUF"
+#endif
+
+#define HANDLE_FREE     0
+#define HANDLE_FILE     1
+#define HANDLE_DIR      2
+#define HANDLE_CLOSING  3   // Closed by the application, not yet by FatFs
+
+// Frames to wait before retrying the card after a failed write-back,
+// doubled on every failure in a row
+#define RETRY_MIN   1
+#define RETRY_MAX   512
+
+static struct handle {
+    uint8_t type;
+    bool write;
+    union {
+        FIL f;
+        DIR d;
+    };
+} handles[FILE_HANDLES];
+
+// Failure of the write-back, kept for the next file_sync()
+static FRESULT writeback_error = FR_OK;
+static uint32_t retry_in = 0, retry_delay = RETRY_MIN;
+
+// Copies a path out of user memory; false if not terminated in time
+static bool user_path(uint32_t p, char *buf)
+{
+    if (!user_range(p, 1)) return false;
+    const char *s = (const char *)p;
+    for (uint32_t i = 0; i < PATH_MAX && p + i < USER_END; i++)
+        if ((buf[i] = s[i]) == '\0') return true;
+    return false;
+}
+
+static inline struct handle *get(uint32_t h, uint8_t type)
+{
+    return (h < FILE_HANDLES && handles[h].type == type ? &handles[h] : NULL);
+}
+
+static int32_t alloc()
+{
+    for (int32_t i = 0; i < FILE_HANDLES; i++)
+        if (handles[i].type == HANDLE_FREE) return i;
+    return -FR_TOO_MANY_OPEN_FILES;
+}
+
+static void fill_info(struct file_info *info, const FILINFO *fi)
+{
+    info->size = (uint32_t)fi->fsize;
+    info->dir = ((fi->fattrib & AM_DIR) != 0);
+    // fname holds at most FF_LFN_BUF characters
+    strcpy(info->name, fi->fname);
+}
+
+int32_t file_open(uint32_t path, uint32_t mode)
+{
+    static char buf[PATH_MAX];
+    if (!user_path(path, buf)) return -FR_INVALID_NAME;
+    if ((mode & ~(FILE_READ | FILE_WRITE | FILE_CREATE | FILE_APPEND)) != 0 ||
+        (mode & (FILE_READ | FILE_WRITE)) == 0)
+        return -FR_INVALID_PARAMETER;
+    int32_t h = alloc();
+    if (h < 0) return h;
+    FRESULT fr = f_open(&handles[h].f, buf, mode);
+    if (fr != FR_OK) return -fr;
+    handles[h].type = HANDLE_FILE;
+    handles[h].write = ((mode & FILE_WRITE) != 0);
+    return h;
+}
+
+int32_t file_opendir(uint32_t path)
+{
+    static char buf[PATH_MAX];
+    if (!user_path(path, buf)) return -FR_INVALID_NAME;
+    int32_t h = alloc();
+    if (h < 0) return h;
+    FRESULT fr = f_opendir(&handles[h].d, buf);
+    if (fr != FR_OK) return -fr;
+    handles[h].type = HANDLE_DIR;
+    handles[h].write = false;
+    return h;
+}
+
+int32_t file_close(uint32_t h)
+{
+    struct handle *f;
+    FRESULT fr;
+    if ((f = get(h, HANDLE_FILE)) != NULL && f->write) {
+        // f_close() syncs, which waits for the card; file_writeback()
+        // does it once the frame is out
+        f->type = HANDLE_CLOSING;
+        return 0;
+    }
+    if (f != NULL) fr = f_close(&f->f);
+    else if ((f = get(h, HANDLE_DIR)) != NULL) fr = f_closedir(&f->d);
+    else return -FR_INVALID_OBJECT;
+    f->type = HANDLE_FREE;
+    return -fr;
+}
+
+int32_t file_read(uint32_t h, uint32_t io)
+{
+    struct handle *f = get(h, HANDLE_FILE);
+    if (f == NULL) return -FR_INVALID_OBJECT;
+    if (!user_range(io, sizeof(struct file_io))) return -FR_INVALID_PARAMETER;
+    struct file_io r = *(const struct file_io *)io;
+    if (!user_range(r.buf, r.len) || r.len > INT32_MAX) return -FR_INVALID_PARAMETER;
+    // Whole sectors go from the card straight to the buffer
+    UINT bread;
+    FRESULT fr = f_read(&f->f, (void *)r.buf, r.len, &bread);
+    return (fr == FR_OK ? (int32_t)bread : -fr);
+}
+
+int32_t file_write(uint32_t h, uint32_t io)
+{
+    struct handle *f = get(h, HANDLE_FILE);
+    if (f == NULL) return -FR_INVALID_OBJECT;
+    if (!user_range(io, sizeof(struct file_io))) return -FR_INVALID_PARAMETER;
+    struct file_io w = *(const struct file_io *)io;
+    if (!user_range(w.buf, w.len) || w.len > INT32_MAX) return -FR_INVALID_PARAMETER;
+    // Goes into the disk cache to be written out after the frame; long
+    // runs of whole sectors go to the card from the buffer
+    UINT bw;
+    FRESULT fr = f_write(&f->f, (const void *)w.buf, w.len, &bw);
+    return (fr == FR_OK ? (int32_t)bw : -fr);
+}
+
+int32_t file_sync(uint32_t h)
+{
+    struct handle *f = get(h, HANDLE_FILE);
+    if (f == NULL) return -FR_INVALID_OBJECT;
+    // Also writes out every sector held back so far, on the spot
+    FRESULT fr = f_sync(&f->f);
+    if (fr == FR_OK) {
+        fr = writeback_error;
+        writeback_error = FR_OK;
+    }
+    return -fr;
+}
+
+void file_writeback()
+{
+    if (retry_in > 0) {
+        retry_in--;
+        return;
+    }
+    FRESULT fr = FR_OK;
+    for (uint32_t i = 0; i < FILE_HANDLES && fr == FR_OK; i++) {
+        if (handles[i].type != HANDLE_CLOSING) continue;
+        // Kept for another try on failure
+        if ((fr = f_close(&handles[i].f)) == FR_OK) handles[i].type = HANDLE_FREE;
+    }
+    if (fr == FR_OK && disk_flush() != 0) fr = FR_DISK_ERR;
+    if (fr == FR_OK) {
+        retry_delay = RETRY_MIN;
+        return;
+    }
+    // Each attempt may spend long in the card's timeouts
+    writeback_error = fr;
+    retry_in = retry_delay;
+    if (retry_delay < RETRY_MAX) retry_delay *= 2;
+}
+
+int32_t file_seek(uint32_t h, uint32_t offs)
+{
+    struct handle *f = get(h, HANDLE_FILE);
+    if (f == NULL) return -FR_INVALID_OBJECT;
+    return -f_lseek(&f->f, offs);
+}
+
+int32_t file_stat(uint32_t path, uint32_t info)
+{
+    static char buf[PATH_MAX];
+    static FILINFO fi;
+    if (!user_path(path, buf)) return -FR_INVALID_NAME;
+    if (!user_range(info, sizeof(struct file_info))) return -FR_INVALID_PARAMETER;
+    FRESULT fr = f_stat(buf, &fi);
+    if (fr != FR_OK) return -fr;
+    fill_info((struct file_info *)info, &fi);
+    return 0;
+}
+
+int32_t file_readdir(uint32_t h, uint32_t info)
+{
+    static FILINFO fi;
+    struct handle *f = get(h, HANDLE_DIR);
+    if (f == NULL) return -FR_INVALID_OBJECT;
+    if (!user_range(info, sizeof(struct file_info))) return -FR_INVALID_PARAMETER;
+    FRESULT fr = f_readdir(&f->d, &fi);
+    if (fr != FR_OK) return -fr;
+    if (fi.fname[0] == '\0') return 0;
+    fill_info((struct file_info *)info, &fi);
+    return 1;
+}
@@ -0,0 +1,50 @@
+#ifndef __MIKAN__FILE_H__
+#define __MIKAN__FILE_H__
+
+#include <stdint.h>
+
+// Files and directories of the mounted volume, opened by the application
+// through system calls. Pointers are user addresses and are checked
+// against the user region; failures return -FRESULT.
+
+#define FILE_HANDLES    8
+#define FILE_NAME_MAX   256     // Including the terminating zero
+
+// Modes of file_open(), as FatFs's FA_* flags
+#define FILE_READ       0x01
+#define FILE_WRITE      0x02
+#define FILE_CREATE     0x08    // Created, or truncated if it exists
+#define FILE_APPEND     0x30    // Created if needed, positioned at the end
+
+struct file_io {
+    uint32_t buf;
+    uint32_t len;
+};
+
+struct file_info {
+    uint32_t size;
+    uint8_t dir;
+    char name[FILE_NAME_MAX];
+};
+
+// Returns the handle
+int32_t file_open(uint32_t path, uint32_t mode);
+int32_t file_opendir(uint32_t path);
+int32_t file_close(uint32_t h);
+// Returns the number of bytes read
+int32_t file_read(uint32_t h, uint32_t io);
+// Returns the number of bytes written, fewer only when the volume is full
+int32_t file_write(uint32_t h, uint32_t io);
+// Writes out everything held back, waiting for the card; also reports
+// a failure of file_writeback() since the last call
+int32_t file_sync(uint32_t h);
+// Called once the frame is presented: finishes closing files written
+// by the application and writes out the sectors held back. Failures
+// are retried after a growing number of frames.
+void file_writeback();
+int32_t file_seek(uint32_t h, uint32_t offs);
+int32_t file_stat(uint32_t path, uint32_t info);
+// Returns 1 with an entry in info, 0 at the end
+int32_t file_readdir(uint32_t h, uint32_t info);
+
+#endif
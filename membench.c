@@ -0,0 +1,75 @@
+// Throughput of the routines in mem.S, per size class
+// Build the kernel with -DMEM_BENCH to have it printed at boot
+
+#ifdef MEM_BENCH
+
+#include "common.h"
+
+#define BENCH_MAX   65536
+#define BENCH_TOTAL (1 << 20)   // Bytes moved per measurement
+
+// Meant to be in the first megabyte, the only cached part of mm_sys;
+// checked before running, as .bss may have grown past it
+static uint8_t bench_src[BENCH_MAX + 64] __attribute__((aligned(32)));
+static uint8_t bench_dst[BENCH_MAX + 64] __attribute__((aligned(32)));
+
+// Cycle counter (ARM1176 TRM p. 3-133)
+static inline void ccnt_init()
+{
+    // Enable, reset the cycle counter, no divider
+    __asm__ __volatile__ ("mcr p15, 0, %0, c15, c12, 0" : : "r" (1 | 4));
+}
+
+static inline uint32_t ccnt()
+{
+    uint32_t c;
+    __asm__ __volatile__ ("mrc p15, 0, %0, c15, c12, 1" : "=r" (c));
+    return c;
+}
+
+#define BENCH_CPY   0
+#define BENCH_CPY_U 1   // Source off by one byte
+#define BENCH_MOVE  2   // Overlapping, destination above the source
+#define BENCH_SET   3
+
+static uint32_t run(uint8_t kind, uint32_t size)
+{
+    uint32_t reps = BENCH_TOTAL / size;
+    uint32_t t0 = ccnt();
+    for (uint32_t i = 0; i < reps; i++) {
+        switch (kind) {
+            case BENCH_CPY: memcpy(bench_dst, bench_src, size); break;
+            case BENCH_CPY_U: memcpy(bench_dst, bench_src + 1, size); break;
+            case BENCH_MOVE: memmove(bench_src + 32, bench_src, size); break;
+            case BENCH_SET: memset(bench_dst, i, size); break;
+        }
+    }
+    return ccnt() - t0;
+}
+
+void mem_bench()
+{
+    static const char *names[4] = { "cpy", "cpy+1", "move", "set" };
+    uint32_t end = (uint32_t)bench_src + sizeof bench_src;
+    if (end < (uint32_t)bench_dst + sizeof bench_dst)
+        end = (uint32_t)bench_dst + sizeof bench_dst;
+    if (end > 0x100000) {
+        printf("Benchmark buffers end at %x, past the cached 1 MB\n", end);
+        return;
+    }
+    ccnt_init();
+    printf("Bytes/cycle\n%-6s", "");
+    for (uint32_t size = 16; size <= BENCH_MAX; size <<= 4) printf("%7u", size);
+    _putchar('\n');
+    for (uint8_t k = 0; k < 4; k++) {
+        printf("%-6s", names[k]);
+        for (uint32_t size = 16; size <= BENCH_MAX; size <<= 4) {
+            uint32_t cycles = run(k, size);
+            uint32_t bpc = (uint64_t)(BENCH_TOTAL / size * size) * 100 / cycles;
+            printf("%4u.%02u", bpc / 100, bpc % 100);
+        }
+        _putchar('\n');
+    }
+}
+
+#endif
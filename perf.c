@@ -0,0 +1,84 @@
+#include "perf.h"
+#include "common.h"
+#include "user/font/font.h"
+
+static struct perf_hist hist[PERF_PHASES];
+
+void perf_reset()
+{
+    memset(hist, 0, sizeof hist);
+}
+
+static inline uint8_t bucket_of(uint32_t us)
+{
+    uint32_t i = us / PERF_BUCKET_US;
+    return (i < PERF_BUCKETS ? i : PERF_BUCKETS - 1);
+}
+
+void perf_add(uint8_t phase, uint32_t us)
+{
+    struct perf_hist *p = &hist[phase];
+    if (p->n == PERF_WINDOW) {
+        // Evict the oldest sample
+        uint32_t old = p->sample[p->pos];
+        p->bucket[bucket_of(old)]--;
+        p->sum -= old;
+    } else {
+        p->n++;
+    }
+    p->sample[p->pos] = us;
+    p->pos = (p->pos + 1) % PERF_WINDOW;
+    p->bucket[bucket_of(us)]++;
+    p->sum += us;
+    if (us > PERF_BUDGET_US) p->overruns++;
+}
+
+uint32_t perf_stat(uint8_t phase, uint8_t stat)
+{
+    if (phase >= PERF_PHASES) return 0;
+    const struct perf_hist *p = &hist[phase];
+    if (stat == PERF_OVERRUNS) return p->overruns;
+    if (p->n == 0) return 0;
+
+    if (stat == PERF_AVG) return p->sum / p->n;
+
+    uint32_t min = UINT32_MAX, max = 0;
+    for (uint8_t i = 0; i < p->n; i++) {
+        if (min > p->sample[i]) min = p->sample[i];
+        if (max < p->sample[i]) max = p->sample[i];
+    }
+    if (stat == PERF_MIN) return min;
+    if (stat == PERF_MAX) return max;
+    if (stat == PERF_P99) {
+        // Upper edge of the bucket holding the slowest 1%
+        uint32_t tail = (p->n + 99) / 100, acc = 0;
+        for (int8_t i = PERF_BUCKETS - 1; i >= 0; i--) {
+            if ((acc += p->bucket[i]) >= tail) {
+                uint32_t edge = (i + 1) * PERF_BUCKET_US;
+                return (edge < max ? edge : max);
+            }
+        }
+    }
+    return 0;
+}
+
+uint32_t perf_hud_height(uint32_t h)
+{
+    uint32_t hud_h = (PERF_PHASES + 1) * FONT_H;
+    return (hud_h < h ? hud_h : h);
+}
+
+uint32_t perf_hud(uint8_t *buf, uint32_t w, uint32_t h, uint32_t pitch, uint32_t bpp)
+{
+    static const char *names[PERF_PHASES] = {
+        "wait", "upd", "draw", "pres", "frm"
+    };
+    print_init(buf, w, h, pitch, bpp);
+    printf("      min   avg   p99   max ovr\n");
+    for (uint8_t i = 0; i < PERF_PHASES; i++)
+        printf("%-4s%6u%6u%6u%6u%4u\n", names[i],
+            perf_stat(i, PERF_MIN), perf_stat(i, PERF_AVG),
+            perf_stat(i, PERF_P99), perf_stat(i, PERF_MAX),
+            perf_stat(i, PERF_OVERRUNS) % 1000);
+    return perf_hud_height(h);
+}
@@ -0,0 +1,44 @@
+#ifndef __MIKAN__PERF_H__
+#define __MIKAN__PERF_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Rolling timing histograms of the phases of the frame loop, in microseconds
+
+#define PERF_WAIT       0   // Waiting for the tick and a free buffer
+#define PERF_UPDATE     1   // All update() calls of a round
+#define PERF_DRAW       2
+#define PERF_PRESENT    3   // Cache write-back and emission of the copy
+#define PERF_FRAME      4   // Everything but the wait
+#define PERF_PHASES     5
+
+#define PERF_MIN        0
+#define PERF_AVG        1
+#define PERF_P99        2
+#define PERF_MAX        3
+#define PERF_OVERRUNS   4   // Samples over one tick, since the start
+
+#define PERF_WINDOW     128
+#define PERF_BUCKETS    64
+#define PERF_BUCKET_US  512 // The last bucket takes everything beyond 32 ms
+#define PERF_BUDGET_US  16667
+
+struct perf_hist {
+    uint32_t sample[PERF_WINDOW];
+    uint8_t bucket[PERF_BUCKETS];
+    uint8_t pos, n;
+    uint32_t sum;
+    uint32_t overruns;
+};
+
+void perf_reset();
+void perf_add(uint8_t phase, uint32_t us);
+uint32_t perf_stat(uint8_t phase, uint8_t stat);
+
+// Rows at the top of a slice of h rows that perf_hud() draws over
+uint32_t perf_hud_height(uint32_t h);
+// Prints the table to the top of a framebuffer slice and returns its height
+uint32_t perf_hud(uint8_t *buf, uint32_t w, uint32_t h, uint32_t pitch, uint32_t bpp);
+
+#endif
@@ -3,8 +3,14 @@
 
 #include <stdint.h>
 
-void print_init(uint8_t *buf, uint32_t w, uint32_t h, uint32_t pitch);
+// bpp is 16 (RGB565), 24 or 32
+void print_init(uint8_t *buf, uint32_t w, uint32_t h, uint32_t pitch, uint32_t bpp);
 void print_setbuf(uint8_t *buf);
+// Scrolling console over a buffer of vh rows, h of them shown at a time.
+// Lines are kept in a ring; scroll() is given the first row to show, and
+// each new line costs clearing it once or twice.
+void print_console(uint8_t *buf, uint32_t w, uint32_t h, uint32_t vh,
+    uint32_t pitch, uint32_t bpp, void (*scroll)(uint32_t offs));
 
 void _putchar(char ch);
 
@@ -0,0 +1,54 @@
+#include "sched.h"
+#include "common.h"
+
+void sched_init(struct sched *s, uint8_t max_catchup, uint8_t max_skip)
+{
+    memset((void *)s, 0, sizeof *s);
+    sched_config(s, max_catchup, max_skip);
+}
+
+void sched_config(struct sched *s, uint8_t max_catchup, uint8_t max_skip)
+{
+    s->max_catchup = (max_catchup < 1 ? 1 : max_catchup);
+    s->max_skip = max_skip;
+    s->skip_run = 0;
+    // Do not replay whatever was missed under the previous policy
+    s->done = s->ticks;
+}
+
+uint32_t sched_wait(struct sched *s)
+{
+    // Same pattern as swapchain_acquire_wait(): no tick can slip in
+    // between the check and the standby
+    _disable_int();
+    while (s->ticks == s->done) {
+        _standby();
+        _enable_int();
+        _disable_int();
+    }
+    uint32_t now = s->ticks;
+    _enable_int();
+
+    uint32_t due = now - s->done;
+    if (due > s->max_catchup) {
+        // Forgotten rather than owed
+        s->lost += due - s->max_catchup;
+        due = s->max_catchup;
+    }
+    s->done = now;
+    s->updates += due;
+    return due;
+}
+
+bool sched_draw(struct sched *s)
+{
+    // Updates took long enough that another tick is already due:
+    // drawing now would only push the loop further behind
+    if (s->ticks != s->done && s->skip_run < s->max_skip) {
+        s->skip_run++;
+        s->skipped++;
+        return false;
+    }
+    s->skip_run = 0;
+    return true;
+}
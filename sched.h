@@ -0,0 +1,40 @@
+#ifndef __MIKAN__SCHED_H__
+#define __MIKAN__SCHED_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Fixed-timestep scheduling of the application's update() and draw().
+// update() runs once per vertical tick, so game time does not slow down
+// when draw() overruns; late ticks are caught up to a bound, and draw()
+// is skipped while the loop is behind.
+
+#define SCHED_MAX_CATCHUP   4   // Updates run back to back at most
+#define SCHED_MAX_SKIP      2   // Consecutive draws skipped at most
+
+struct sched {
+    uint8_t max_catchup;    // 1 = no catch-up, late ticks are lost
+    uint8_t max_skip;       // 0 = draw after every batch of updates
+    uint8_t skip_run;
+    // Written by the tick interrupt only
+    volatile uint32_t ticks;
+    uint32_t done;          // Ticks accounted for by the main loop
+
+    uint32_t updates;
+    uint32_t skipped;       // draw() calls left out
+    uint32_t lost;          // Ticks beyond the catch-up bound
+};
+
+void sched_init(struct sched *s, uint8_t max_catchup, uint8_t max_skip);
+void sched_config(struct sched *s, uint8_t max_catchup, uint8_t max_skip);
+
+// Called from the tick interrupt
+static inline void sched_tick(struct sched *s) { s->ticks++; }
+
+// Sleeps until at least one tick is due; returns the number of
+// updates to run now
+uint32_t sched_wait(struct sched *s);
+// Called after the updates; false if this frame's draw is to be skipped
+bool sched_draw(struct sched *s);
+
+#endif
@@ -82,24 +82,19 @@ int strncmp(char const *str1, char const *str2, int len)
 	return 0;
 }
 
+// Both go to the kernel's burst routines in mem.S
+extern void *memset(void *str, int c, size_t n);
+extern void *memcpy(void *dest, const void *src, size_t n);
+
 void *memSet(void *str, int c, size_t n)
 {
-	char *dst = (char *) str;
-	while(n--) {
-		*dst++ = (char) (c & 0xFF);
-	}
-	return str;
+	return memset(str, c, n);
 }
 
 
 void *memCopy(void *dest, const void *src, size_t n)
 {
-	char *d = (char *) dest;
-	char *s = (char *) src;
-	while(n--) {
-		*d++ = *s++;
-	}
-	return dest;
+	return memcpy(dest, src, n);
 }
 
 int memCompare(const void *str1, const void *str2, size_t n)
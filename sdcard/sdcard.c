@@ -27,6 +27,7 @@
 //#include "devices/console.h"
 #define P2V_DEV(X) (X)
 #include "../printf/printf.h"
+#include "../dma_fifo.h"
 #define LOG_DEBUG printf
 #define LOG_ERROR printf
 
@@ -515,6 +516,17 @@ int mbxGetClockRate(int id)
 	return get_clock_rate(id);
 }
 
+// Writes of this many blocks or more are announced for pre-erasing.
+#define SD_PRE_ERASE_MIN 16
+
+#ifndef SD_PIO
+#define EMMC_DATA_BUS    0x7e300020
+
+// Unaligned buffers are transferred through this, a few blocks at a time.
+#define SD_BOUNCE_BLOCKS 16
+static unsigned char sdBounce[SD_BOUNCE_BLOCKS * 512] __attribute__((aligned(32)));
+#endif
+
 //**************************************************************************
 // SD Card PUBLIC functions.
 //**************************************************************************
@@ -1060,9 +1072,47 @@ static int sdSwitchVoltage()
   return SD_OK;
 }
 
+#ifndef SD_PIO
+/* Reset the data circuit after a failed transfer: drop whatever is left
+ * in the FIFO, and clear the interrupts it raised so that the next
+ * transfer does not see them.
+ */
+static void sdResetData()
+  {
+  *EMMC_CONTROL1 |= C1_SRST_DATA;
+  int count = 10000;
+  while( (*EMMC_CONTROL1 & C1_SRST_DATA) && count-- )
+    waitMicro(10);
+  if( count <= 0 )
+    LOG_ERROR("EMMC: Timeout resetting the data circuit\n");
+  *EMMC_INTERRUPT = *EMMC_INTERRUPT;
+  }
+
+/* Wait for the DMA engine to move the data of a transfer through the FIFO.
+ */
+static int sdWaitForDMA()
+  {
+  // Same limit as sdWaitForInterrupt(), stopping early on a card error.
+  int count = 1000000;
+  int state;
+  while( (state = dma_fifo_poll()) > 0 && !(*EMMC_INTERRUPT & INT_ERROR_MASK) && count-- )
+    waitMicro(1);
+  if( state != 0 )
+    {
+    LOG_ERROR("EMMC: DMA %s: %08x %08x %08x\n",state < 0 ? "error" : "timeout",*EMMC_STATUS,*EMMC_INTERRUPT,*EMMC_BLKSIZECNT);
+    dma_fifo_abort();
+    sdResetData();
+    return state < 0 ? SD_ERROR : SD_TIMEOUT;
+    }
+
+  return SD_OK;
+  }
+#endif
+
 /* Transfer multiple contiguous blocks between the given address on the card and the buffer.
+ * Without SD_PIO the buffer must be cache line aligned.
  */
-int sdTransferBlocks( long long address, int numBlocks, unsigned char* buffer, int write )
+static int sdTransferDirect( long long address, int numBlocks, unsigned char* buffer, int write )
 {
 	//	printf("check sdCard.init\n"); // TEST
   if( !sdCard.init ) return SD_NO_RESP;
@@ -1072,14 +1122,21 @@ int sdTransferBlocks( long long address, int numBlocks, unsigned char* buffer, i
   if( sdWaitForData() ) return SD_TIMEOUT;
 
   // Work out the status, interrupt and command values for the transfer.
-  int readyInt = write ? INT_WRITE_RDY : INT_READ_RDY;
   //int readyData = write ? SR_WRITE_AVAILABLE : SR_READ_AVAILABLE;
   int transferCmd = write ? ( numBlocks == 1 ? IX_WRITE_SINGLE : IX_WRITE_MULTI) :
                             ( numBlocks == 1 ? IX_READ_SINGLE : IX_READ_MULTI);
 
+  // For a long write, tell the card how many blocks are coming (ACMD23,
+  // listed as SEND_NUM_ERS) so that it can erase them ahead of the data.
+  // It goes first: ACMD23, then SET_BLOCK_COUNT, then the write is the
+  // order the spec allows. Only a hint; a card that refuses it still
+  // takes the write.
+  int resp;
+  if( write && numBlocks >= SD_PRE_ERASE_MIN )
+    sdSendCommandA(IX_SEND_NUM_ERS,numBlocks);
+
   // If more than one block to transfer, and the card supports it,
   // send SET_BLOCK_COUNT command to indicate the number of blocks to transfer.
-  int resp;
   if( numBlocks > 1 &&
       (sdCard.support & SD_SUPP_SET_BLOCK_COUNT) &&
       (resp = sdSendCommandA(IX_SET_BLOCKCNT,numBlocks)) ) return sdDebugResponse(resp);
@@ -1098,6 +1155,22 @@ int sdTransferBlocks( long long address, int numBlocks, unsigned char* buffer, i
   //	printf("sdSendCommandA() .init\n"); // TEST
   if( (resp = sdSendCommandA(transferCmd,blockAddress)) ) return sdDebugResponse(resp);
 
+#ifndef SD_PIO
+  // The DMA engine fills or drains the FIFO whenever the EMMC raises its DREQ,
+  // across block boundaries, so the CPU is free of the data register.
+  int blocksDone = numBlocks;
+  dma_fifo_start(buffer,EMMC_DATA_BUS,numBlocks * 512,DMA_DREQ_EMMC,write);
+  if( (resp = sdWaitForDMA()) )
+    {
+    // Leave the card out of the data state, even where it was told
+    // how many blocks to expect.
+    if( numBlocks > 1 )
+      sdSendCommand(IX_STOP_TRANS);
+    return resp;
+    }
+#else
+  int readyInt = write ? INT_WRITE_RDY : INT_READ_RDY;
+
   // Transfer all blocks.
   int blocksDone = 0;
   while( blocksDone < numBlocks )
@@ -1153,6 +1226,8 @@ int sdTransferBlocks( long long address, int numBlocks, unsigned char* buffer, i
     buffer += 512;
     }
 
+#endif
+
   // If not all bytes were read, the operation timed out.
   if( blocksDone != numBlocks )
     {
@@ -1182,6 +1257,32 @@ int sdTransferBlocks( long long address, int numBlocks, unsigned char* buffer, i
   return SD_OK;
   }
 
+/* Transfer multiple contiguous blocks between the given address on the card and the buffer.
+ */
+int sdTransferBlocks( long long address, int numBlocks, unsigned char* buffer, int write )
+  {
+#ifndef SD_PIO
+  // DMA straight into a buffer that does not share cache lines with anything else,
+  // through the bounce buffer otherwise.
+  if( (int)buffer & 31 )
+    {
+    while( numBlocks > 0 )
+      {
+      int n = numBlocks < SD_BOUNCE_BLOCKS ? numBlocks : SD_BOUNCE_BLOCKS;
+      int resp;
+      if( write ) memCopy(sdBounce,buffer,n * 512);
+      if( (resp = sdTransferDirect(address,n,sdBounce,write)) ) return resp;
+      if( !write ) memCopy(buffer,sdBounce,n * 512);
+      address += n * 512;
+      buffer += n * 512;
+      numBlocks -= n;
+      }
+    return SD_OK;
+    }
+#endif
+  return sdTransferDirect(address,numBlocks,buffer,write);
+  }
+
 /* Clear multiple contiguous blocks.
  * Assumes that the erase operation writes zeros to the file.
  */
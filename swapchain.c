@@ -0,0 +1,108 @@
+#include "swapchain.h"
+#include "common.h"
+
+void swapchain_init(struct swapchain *sc, uint8_t count, uint8_t policy)
+{
+    memset((void *)sc, 0, sizeof *sc);
+    swapchain_config(sc, count, policy);
+}
+
+void swapchain_config(struct swapchain *sc, uint8_t count, uint8_t policy)
+{
+    if (count < 2) count = 2;
+    if (count > SWAP_MAX) count = SWAP_MAX;
+    if (sc->shown >= count) sc->shown = 0;
+
+    // Frames waiting in the queue are lost
+    sc->dropped += (uint8_t)(sc->tail - sc->head);
+    sc->head = sc->tail = 0;
+
+    sc->count = count;
+    sc->policy = policy;
+    for (uint8_t i = 0; i < SWAP_MAX; i++) sc->state[i] = SWAP_FREE;
+    sc->state[sc->shown] = SWAP_SHOWN;
+    DMB();
+}
+
+int8_t swapchain_acquire(struct swapchain *sc)
+{
+    for (uint8_t i = 0; i < sc->count; i++) {
+        // Round-robin from the buffer on screen, so that the oldest is reused
+        uint8_t id = (sc->shown + 1 + i) % sc->count;
+        if (sc->state[id] == SWAP_FREE) {
+            sc->state[id] = SWAP_ACQUIRED;
+            DMB();
+            return id;
+        }
+    }
+    return -1;
+}
+
+uint8_t swapchain_acquire_wait(struct swapchain *sc)
+{
+    int8_t id;
+    while (1) {
+        // Interrupts are masked between the check and the standby so that
+        // a flip cannot sneak in and leave us sleeping for a whole tick;
+        // a pending interrupt still wakes the core up
+        _disable_int();
+        if ((id = swapchain_acquire(sc)) >= 0) break;
+        _standby();
+        _enable_int();
+    }
+    _enable_int();
+    return id;
+}
+
+void swapchain_present(struct swapchain *sc, uint8_t id, uint32_t fence)
+{
+    sc->fence[id] = fence;
+    sc->state[id] = SWAP_QUEUED;
+    sc->queue[sc->tail % SWAP_MAX] = id;
+    DMB();
+    sc->tail++;
+    sc->presented++;
+    DMB();
+}
+
+void swapchain_cancel(struct swapchain *sc, uint8_t id)
+{
+    DMB();
+    sc->state[id] = SWAP_FREE;
+}
+
+int8_t swapchain_flip(struct swapchain *sc)
+{
+    uint8_t head = sc->head, tail = sc->tail;
+    int8_t next = -1;
+
+    if (sc->policy == SWAP_THROUGHPUT) {
+        if (head != tail && dma_signalled(sc->fence[sc->queue[head % SWAP_MAX]]))
+            next = sc->queue[head++ % SWAP_MAX];
+    } else {
+        // Take the newest frame that is ready, dropping the ones before it
+        uint8_t ready = head;
+        for (uint8_t i = head; i != tail; i++)
+            if (dma_signalled(sc->fence[sc->queue[i % SWAP_MAX]])) ready = i + 1;
+        for (; head != ready; head++) {
+            if (next >= 0) {
+                sc->state[next] = SWAP_FREE;
+                sc->dropped++;
+            }
+            next = sc->queue[head % SWAP_MAX];
+        }
+    }
+
+    if (next < 0) {
+        sc->repeated++;
+        return -1;
+    }
+
+    sc->state[sc->shown] = SWAP_FREE;
+    sc->state[next] = SWAP_SHOWN;
+    sc->shown = next;
+    sc->flips++;
+    DMB();
+    sc->head = head;
+    return next;
+}
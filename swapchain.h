@@ -0,0 +1,54 @@
+#ifndef __MIKAN__SWAPCHAIN_H__
+#define __MIKAN__SWAPCHAIN_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Single-producer/single-consumer swap chain: the main loop acquires and
+// presents buffers, the vertical tick interrupt flips them on screen.
+// Each buffer is owned by exactly one side at a time, so no locking is
+// needed beyond single-byte stores and barriers.
+
+#define SWAP_MAX    4
+
+#define SWAP_FREE       0   // May be acquired by the producer
+#define SWAP_ACQUIRED   1   // Being rendered
+#define SWAP_QUEUED     2   // Presented, waiting for a flip
+#define SWAP_SHOWN      3   // Being scanned out
+
+#define SWAP_LOW_LATENCY    0   // The newest presented frame wins
+#define SWAP_THROUGHPUT     1   // Every presented frame is shown, in order
+
+struct swapchain {
+    uint8_t count;
+    uint8_t policy;
+    volatile uint8_t state[SWAP_MAX];
+    // DMA fence to be signalled before a buffer may be shown
+    volatile uint32_t fence[SWAP_MAX];
+    // Presented buffers in order; tail is written by the producer only,
+    // head by the consumer only
+    volatile uint8_t queue[SWAP_MAX];
+    volatile uint8_t head, tail;
+    volatile uint8_t shown;
+
+    volatile uint32_t presented;
+    volatile uint32_t flips;
+    volatile uint32_t dropped;      // Presented but never shown
+    volatile uint32_t repeated;     // Ticks without a new frame
+};
+
+void swapchain_init(struct swapchain *sc, uint8_t count, uint8_t policy);
+// Must be called with interrupts disabled; the buffer on screen stays there
+void swapchain_config(struct swapchain *sc, uint8_t count, uint8_t policy);
+
+// Producer side
+int8_t swapchain_acquire(struct swapchain *sc);
+// Sleeps until a buffer is free
+uint8_t swapchain_acquire_wait(struct swapchain *sc);
+void swapchain_present(struct swapchain *sc, uint8_t id, uint32_t fence);
+void swapchain_cancel(struct swapchain *sc, uint8_t id);
+
+// Consumer side; returns the buffer to show, or -1 to keep the current one
+int8_t swapchain_flip(struct swapchain *sc);
+
+#endif
@@ -0,0 +1,92 @@
+#include "asset.h"
+
+#include <string.h>
+
+bool asset_info_get(const uint8_t *src, uint32_t size, asset_info *info)
+{
+    if (size < ASSET_HEADER_SIZE || src[0] != 'M' || src[1] != 'I') return false;
+    info->format = src[2];
+    info->bpp = src[3];
+    info->w = src[4] | (src[5] << 8);
+    info->h = src[6] | (src[7] << 8);
+    return (info->format <= ASSET_QOI &&
+        (info->bpp == 16 || info->bpp == 24 || info->bpp == 32));
+}
+
+static inline uint8_t hash(uint32_t c)
+{
+    return ((c >> 16) * 3 + ((c >> 8) & 0xff) * 5 + (c & 0xff) * 7) & 63;
+}
+
+// One decoder per depth, so that storing a pixel is a few instructions
+#define ASSET_DECODER(_name, _bypp, _put)                                       \
+static uint32_t _name(const uint8_t *s, const uint8_t *end,                     \
+    uint8_t *dst, uint32_t pitch, uint32_t w, uint32_t h)                       \
+{                                                                               \
+    uint32_t index[64] = { 0 };                                                 \
+    uint32_t c = 0, run = 0, n = 0;                                             \
+    for (uint32_t y = 0; y < h; y++) {                                          \
+        uint8_t *p = dst + y * pitch;                                           \
+        for (uint32_t x = 0; x < w; x++, p += (_bypp)) {                        \
+            if (run > 0) {                                                      \
+                run--;                                                          \
+            } else {                                                            \
+                if (s >= end) return n;                                         \
+                uint8_t op = *s++;                                              \
+                if (op == 0xfe) {                                               \
+                    if (end - s < 3) return n;                                  \
+                    c = s[0] | (s[1] << 8) | (s[2] << 16);                      \
+                    s += 3;                                                     \
+                } else if ((op >> 6) == 0) {                                    \
+                    c = index[op];                                              \
+                } else if ((op >> 6) == 1) {                                    \
+                    uint32_t r = ((c >> 16) + ((op >> 4) & 3) - 2) & 0xff;      \
+                    uint32_t g = ((c >> 8) + ((op >> 2) & 3) - 2) & 0xff;       \
+                    uint32_t b = (c + (op & 3) - 2) & 0xff;                     \
+                    c = (r << 16) | (g << 8) | b;                               \
+                } else if ((op >> 6) == 2) {                                    \
+                    if (s >= end) return n;                                     \
+                    int32_t dg = (op & 63) - 32;                                \
+                    uint32_t r = ((c >> 16) + dg + (*s >> 4) - 8) & 0xff;       \
+                    uint32_t g = ((c >> 8) + dg) & 0xff;                        \
+                    uint32_t b = (c + dg + (*s & 15) - 8) & 0xff;               \
+                    s++;                                                        \
+                    c = (r << 16) | (g << 8) | b;                               \
+                } else {                                                        \
+                    run = op & 63;                                              \
+                }                                                               \
+                index[hash(c)] = c;                                             \
+            }                                                                   \
+            _put;                                                               \
+            n++;                                                                \
+        }                                                                       \
+    }                                                                           \
+    return n;                                                                   \
+}
+
+ASSET_DECODER(decode16, 2,
+    *(uint16_t *)p = ((c >> 8) & 0xf800) | ((c >> 5) & 0x07e0) | ((c >> 3) & 0x1f))
+ASSET_DECODER(decode24, 3,
+    (p[0] = c, p[1] = c >> 8, p[2] = c >> 16))
+ASSET_DECODER(decode32, 4,
+    *(uint32_t *)p = c)
+
+uint32_t asset_decode(const uint8_t *src, uint32_t size, void *dst, uint32_t pitch)
+{
+    asset_info info;
+    if (!asset_info_get(src, size, &info)) return 0;
+    const uint8_t *s = src + ASSET_HEADER_SIZE, *end = src + size;
+    uint8_t *d = (uint8_t *)dst;
+
+    if (info.format == ASSET_RAW) {
+        uint32_t row = info.w * (info.bpp / 8), y;
+        for (y = 0; y < info.h && (uint32_t)(end - s) >= row; y++, s += row, d += pitch)
+            memcpy(d, s, row);
+        return y * info.w;
+    }
+    switch (info.bpp) {
+        case 16: return decode16(s, end, d, pitch, info.w, info.h);
+        case 24: return decode24(s, end, d, pitch, info.w, info.h);
+        default: return decode32(s, end, d, pitch, info.w, info.h);
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef __MIKAN__ASSET_H__
+#define __MIKAN__ASSET_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Images baked by bake.c at their final size and depth. An 8-byte header
+// ("MI", format, bpp, width and height, little-endian) is followed by
+// either raw rows or a QOI-style stream of ops:
+//   00iiiiii               pixel i of the 64 most recently hashed
+//   01rrggbb               channel differences -2 ~ 1 from the previous
+//   10gggggg rrrrbbbb      green difference -32 ~ 31, red and blue
+//                          differences -8 ~ 7 relative to it
+//   11nnnnnn               previous pixel repeated n + 1 times, n < 62
+//   11111110 b g r         literal
+// Channels are those of 0xRRGGBB; 16 bpp images are quantised when baked
+// so that they decode to exact RGB565.
+
+#define ASSET_RAW   0
+#define ASSET_QOI   1
+
+#define ASSET_HEADER_SIZE   8
+
+typedef struct asset_info {
+    uint16_t w, h;
+    uint8_t bpp;
+    uint8_t format;
+} asset_info;
+
+// False if src does not start with a valid header
+bool asset_info_get(const uint8_t *src, uint32_t size, asset_info *info);
+// Decodes straight into dst, rows pitch bytes apart; returns the number of
+// pixels written, short of w * h if the data ends early
+uint32_t asset_decode(const uint8_t *src, uint32_t size, void *dst, uint32_t pitch);
+
+#endif
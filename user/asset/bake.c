@@ -0,0 +1,163 @@
+// Host tool: bakes a raw 24-bit image into an asset for asset_decode().
+// cc -O2 -std=c99 bake.c -o bake
+//
+// Input pixels are [B, G, R] bytes, as ffmpeg's -pix_fmt bgr24 writes.
+// The source is scaled to scale_w x scale_h (nearest neighbour), then
+// the w x h rectangle at (x, y) of it is kept. As a C initialiser, the
+// output also defines ASSET_W, ASSET_H and ASSET_BPP.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asset.c"
+
+static uint8_t *out;
+static uint32_t out_len;
+
+static void emit(uint8_t b)
+{
+    out[out_len++] = b;
+}
+
+static void encode(const uint32_t *px, uint32_t count)
+{
+    uint32_t index[64] = { 0 };
+    uint32_t prev = 0, run = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t c = px[i];
+        if (c == prev) {
+            if (++run == 62 || i == count - 1) {
+                emit(0xc0 | (run - 1));
+                run = 0;
+            }
+            continue;
+        }
+        if (run > 0) {
+            emit(0xc0 | (run - 1));
+            run = 0;
+        }
+        uint8_t h = hash(c);
+        if (index[h] == c) {
+            emit(h);
+        } else {
+            index[h] = c;
+            int8_t dr = (int8_t)((c >> 16) - (prev >> 16));
+            int8_t dg = (int8_t)((c >> 8) - (prev >> 8));
+            int8_t db = (int8_t)(c - prev);
+            int8_t dr_dg = dr - dg, db_dg = db - dg;
+            if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                emit(0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2));
+            } else if (dg >= -32 && dg <= 31 &&
+                    dr_dg >= -8 && dr_dg <= 7 && db_dg >= -8 && db_dg <= 7) {
+                emit(0x80 | (dg + 32));
+                emit(((dr_dg + 8) << 4) | (db_dg + 8));
+            } else {
+                emit(0xfe);
+                emit(c);
+                emit(c >> 8);
+                emit(c >> 16);
+            }
+        }
+        prev = c;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int raw = 0, binary = 0, a = 1;
+    for (; a < argc && argv[a][0] == '-'; a++) {
+        if (strcmp(argv[a], "-r") == 0) raw = 1;
+        else if (strcmp(argv[a], "-b") == 0) binary = 1;
+    }
+    if (argc - a != 9) {
+        fprintf(stderr, "Usage: %s [-r] [-b] <src w> <src h> <scale w> <scale h> "
+            "<x> <y> <w> <h> <bpp> < in.bgr > out\n"
+            "  -r  store uncompressed\n"
+            "  -b  write binary instead of a C initialiser\n", argv[0]);
+        return 1;
+    }
+    uint32_t v[9];
+    for (int i = 0; i < 9; i++) v[i] = strtoul(argv[a + i], NULL, 0);
+    uint32_t sw = v[0], sh = v[1], scw = v[2], sch = v[3];
+    uint32_t x0 = v[4], y0 = v[5], w = v[6], h = v[7], bpp = v[8];
+    if (bpp != 16 && bpp != 24 && bpp != 32) {
+        fprintf(stderr, "Depth must be 16, 24 or 32\n");
+        return 1;
+    }
+    if (x0 + w > scw || y0 + h > sch || w > 65535 || h > 65535) {
+        fprintf(stderr, "Rectangle outside the scaled image\n");
+        return 1;
+    }
+
+    uint8_t *src = malloc(sw * sh * 3);
+    if (!src || fread(src, 3, sw * sh, stdin) != sw * sh) {
+        fprintf(stderr, "Cannot read %ux%u pixels\n", sw, sh);
+        return 2;
+    }
+    uint32_t *px = malloc(w * h * sizeof(uint32_t));
+    for (uint32_t y = 0; y < h; y++)
+    for (uint32_t x = 0; x < w; x++) {
+        const uint8_t *p = src + (((y + y0) * sh / sch) * sw + (x + x0) * sw / scw) * 3;
+        uint32_t b = p[0], g = p[1], r = p[2];
+        if (bpp == 16) {
+            // Keep what RGB565 can hold, with the top bits replicated
+            r = (r & 0xf8) | (r >> 5);
+            g = (g & 0xfc) | (g >> 6);
+            b = (b & 0xf8) | (b >> 5);
+        }
+        px[y * w + x] = (r << 16) | (g << 8) | b;
+    }
+
+    uint32_t bypp = bpp / 8;
+    out = malloc(ASSET_HEADER_SIZE + w * h * 5);
+    emit('M');
+    emit('I');
+    emit(raw ? ASSET_RAW : ASSET_QOI);
+    emit(bpp);
+    emit(w);
+    emit(w >> 8);
+    emit(h);
+    emit(h >> 8);
+    if (raw) {
+        for (uint32_t i = 0; i < w * h; i++) {
+            uint32_t c = px[i];
+            if (bpp == 16)
+                c = ((c >> 8) & 0xf800) | ((c >> 5) & 0x07e0) | ((c >> 3) & 0x1f);
+            for (uint32_t k = 0; k < bypp; k++) emit(c >> (k * 8));
+        }
+    } else {
+        encode(px, w * h);
+    }
+
+    // Decode again to be sure
+    uint8_t *check = calloc(w * h, bypp);
+    if (asset_decode(out, out_len, check, w * bypp) != w * h) {
+        fprintf(stderr, "Decoding came short\n");
+        return 3;
+    }
+    for (uint32_t i = 0; i < w * h; i++) {
+        uint32_t c = 0;
+        for (uint32_t k = 0; k < bypp; k++) c |= check[i * bypp + k] << (k * 8);
+        uint32_t e = px[i];
+        if (bpp == 16) e = ((e >> 8) & 0xf800) | ((e >> 5) & 0x07e0) | ((e >> 3) & 0x1f);
+        if (c != e) {
+            fprintf(stderr, "Mismatch at pixel %u\n", i);
+            return 3;
+        }
+    }
+    fprintf(stderr, "%ux%u at %u bpp: %u bytes (%u raw)\n",
+        w, h, bpp, out_len, ASSET_HEADER_SIZE + w * h * bypp);
+
+    if (binary) {
+        fwrite(out, 1, out_len, stdout);
+    } else {
+        // For the including file to check at build time what it got
+        printf("#undef ASSET_W\n#undef ASSET_H\n#undef ASSET_BPP\n"
+            "#define ASSET_W %u\n#define ASSET_H %u\n#define ASSET_BPP %u\n", w, h, bpp);
+        for (uint32_t i = 0; i < out_len; i++)
+            printf("%s0x%02x,%s", (i % 12 == 0 ? "  " : " "), out[i],
+                (i % 12 == 11 || i == out_len - 1 ? "\n" : ""));
+    }
+    return 0;
+}
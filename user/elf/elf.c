@@ -1,5 +1,4 @@
 #include "elf.h"
-#include <stddef.h>
 
 // Reference document
 // http://infocenter.arm.com/help/topic/com.arm.doc.ihi0044f/IHI0044F_aaelf.pdf
@@ -31,49 +30,59 @@ static uint8_t check_ehdr(const elf_ehdr *ehdr)
     return ELF_E_NONE;
 }
 
-static inline const elf_shdr *get_shdr(const elf_ehdr *ehdr)
+#ifdef ELF_TEST
+// Section headers are not needed for loading; read them one at a time,
+// names included, only to be logged
+static void log_sections(const elf_reader *r, const elf_ehdr *ehdr)
 {
-    return (const elf_shdr *)((const char *)ehdr + ehdr->shoffs);
-}
+    if (ehdr->shentsize != sizeof(elf_shdr)) return;
+    elf_shdr strtab;
+    bool names = (ehdr->shstrndx != 0 && ehdr->shstrndx < ehdr->shnum &&
+        r->read(r->ctx, ehdr->shoffs + ehdr->shstrndx * sizeof(elf_shdr),
+            &strtab, sizeof strtab));
 
-static inline const elf_phdr *get_phdr(const elf_ehdr *ehdr)
-{
-    return (const elf_phdr *)((const char *)ehdr + ehdr->phoffs);
-}
-
-static inline const char *get_strtab(const elf_ehdr *ehdr)
-{
-    return (ehdr->shstrndx == 0) ?  NULL :
-        (const char *)ehdr + get_shdr(ehdr)[ehdr->shstrndx].offs;
-}
-
-static inline const char *get_strtab_ent(const elf_ehdr *ehdr, uint32_t offs)
-{
-    const char *table = get_strtab(ehdr);
-    return table ? table + offs : NULL;
+    for (uint32_t i = 0; i < ehdr->shnum; i++) {
+        elf_shdr section;
+        if (!r->read(r->ctx, ehdr->shoffs + i * sizeof(elf_shdr),
+                &section, sizeof section))
+            return;
+        char name[32] = { 0 };
+        if (names && section.name < strtab.size) {
+            uint32_t len = strtab.size - section.name;
+            if (len > sizeof name - 1) len = sizeof name - 1;
+            if (!r->read(r->ctx, strtab.offs + section.name, name, len))
+                name[0] = '\0';
+        }
+        ELF_LOG("section [%s] type = 0x%x, flags = %c%c%c, addr = 0x%x (align %d), "
+            "offset = 0x%x, size = %d\n",
+            name, section.type,
+            (section.flags & 1) ? 'W' : '.',
+            (section.flags & 2) ? 'A' : '.',
+            (section.flags & 4) ? 'X' : '.',
+            section.addr, section.addralign, section.offs, section.size);
+    }
 }
+#endif
 
-uint8_t load_elf(const char *buf)
+uint8_t load_elf(const elf_reader *r, elf_addr *entry)
 {
-    const elf_ehdr *ehdr = (elf_ehdr *)buf;
+    elf_ehdr ehdr;
+    if (!r->read(r->ctx, 0, &ehdr, sizeof ehdr)) return ELF_E_INVALID;
 
-    uint8_t ehdr_result = check_ehdr(ehdr);
+    uint8_t ehdr_result = check_ehdr(&ehdr);
     if (ehdr_result != ELF_E_NONE) return ehdr_result;
+#ifdef ELF_TEST
+    log_sections(r, &ehdr);
+#endif
+    if (ehdr.phentsize != sizeof(elf_phdr) || ehdr.phnum > ELF_MAX_PHDRS)
+        return ELF_E_UNSUPPORT;
 
-    const elf_shdr *shdr = get_shdr(ehdr);
-    for (uint32_t i = 0; i < ehdr->shnum; i++) {
-        const elf_shdr *section = shdr + i;
-        ELF_LOG("section [%s] type = 0x%x, flags = %c%c%c, addr = 0x%x (align %d), "
-            "offset = 0x%x, size = %d\n",
-            get_strtab_ent(ehdr, section->name), section->type,
-            (section->flags & 1) ? 'W' : '.',
-            (section->flags & 2) ? 'A' : '.',
-            (section->flags & 4) ? 'X' : '.',
-            section->addr, section->addralign, section->offs, section->size);
-    }
+    // All program headers at once, before any segment moves the file offset
+    elf_phdr phdr[ELF_MAX_PHDRS];
+    if (!r->read(r->ctx, ehdr.phoffs, phdr, ehdr.phnum * sizeof(elf_phdr)))
+        return ELF_E_INVALID;
 
-    const elf_phdr *phdr = get_phdr(ehdr);
-    for (uint32_t i = 0; i < ehdr->phnum; i++) {
+    for (uint32_t i = 0; i < ehdr.phnum; i++) {
         const elf_phdr *program = phdr + i;
         ELF_LOG("program type = 0x%x, offset = 0x%x, "
             "vaddr = 0x%x, paddr = 0x%x, filesz = %d, memsz = %d, "
@@ -85,8 +94,12 @@ uint8_t load_elf(const char *buf)
             (program->flags & 2) ? 'W' : ' ',
             (program->flags & 1) ? 'X' : ' ',
             program->align);
-        load_program(ehdr, program);
+        if (program->type != ELF_PT_LOAD) continue;
+        if (program->filesz > program->memsz) return ELF_E_INVALID;
+        uint8_t result = load_program(r, program);
+        if (result != ELF_E_NONE) return result;
     }
 
+    *entry = ehdr.entry;
     return ELF_E_NONE;
 }
@@ -1,6 +1,7 @@
 #ifndef __MIKAN__ELF_H__
 #define __MIKAN__ELF_H__
 
+#include <stdbool.h>
 #include <stdint.h>
 
 typedef uint16_t elf_half;
@@ -54,9 +55,22 @@ typedef struct {
 #define ELF_E_INVALID   1
 #define ELF_E_UNSUPPORT 2
 
-uint8_t load_elf(const char *buf);
+#define ELF_PT_LOAD     1
+#define ELF_MAX_PHDRS   16
 
-void load_program(const elf_ehdr *ehdr, const elf_phdr *program);
+// Source of the file: reads len bytes at offset offs into dst,
+// returning whether all of them were read
+typedef struct elf_reader {
+    bool (*read)(void *ctx, uint32_t offs, void *dst, uint32_t len);
+    void *ctx;
+} elf_reader;
+
+// Reads the ELF header and the program headers, then has each PT_LOAD
+// segment placed by load_program(), which reads its file range with r
+// straight to where it belongs
+uint8_t load_elf(const elf_reader *r, elf_addr *entry);
+
+uint8_t load_program(const elf_reader *r, const elf_phdr *program);
 
 #ifdef ELF_TEST
 #include <stdio.h>
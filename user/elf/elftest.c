@@ -3,7 +3,20 @@
 
 #include "elf.h"
 
-void load_program(const elf_ehdr *ehdr, const elf_phdr *program) { }
+static bool file_read(void *ctx, uint32_t offs, void *dst, uint32_t len)
+{
+    FILE *f = (FILE *)ctx;
+    return (fseek(f, offs, SEEK_SET) == 0 && fread(dst, 1, len, f) == len);
+}
+
+// Reads the segment without placing it anywhere
+uint8_t load_program(const elf_reader *r, const elf_phdr *program)
+{
+    char *buf = (char *)malloc(program->filesz + 1);
+    bool ok = (buf && r->read(r->ctx, program->offs, buf, program->filesz));
+    free(buf);
+    return (ok ? ELF_E_NONE : ELF_E_INVALID);
+}
 
 int main(int argc, char *argv[])
 {
@@ -12,30 +25,17 @@ int main(int argc, char *argv[])
         return 0;
     }
 
-    FILE *f = fopen(argv[1], "r");
+    FILE *f = fopen(argv[1], "rb");
     if (!f) {
         printf("Cannot open file %s\n", argv[1]);
         return 1;
     }
 
-    fseek(f, 0, SEEK_END);
-    long len = ftell(f);
-    fseek(f, 0, SEEK_SET);
-
-    char *buf = (char *)malloc(len);
-    if (!buf) {
-        printf("Cannot allocate memory for reading the entire file\n");
-        return 2;
-    }
-    if (fread(buf, len, 1, f) != 1) {
-        printf("Cannot read from file %s\n", argv[1]);
-        return 3;
-    }
-    fclose(f);
-
-    printf("File size %lu B\n", len);
-    uint8_t ret = load_elf(buf);
+    elf_reader reader = { file_read, f };
+    elf_addr entry;
+    uint8_t ret = load_elf(&reader, &entry);
     printf("load_elf returns %d\n", ret);
+    fclose(f);
 
     return 0;
 }
@@ -0,0 +1,252 @@
+#include "fixmath.h"
+
+#include <stdbool.h>
+
+// Tables from
+// python3 -c "import math; print([round(math.sin(i / 256 * math.pi / 2) * 65536) for i in range(257)])"
+// python3 -c "import math; print([round(math.atan(i / 256) / (2 * math.pi) * 65536) for i in range(257)])"
+// python3 -c "print([round(2 ** 30 / ((64 + i + 0.5) / 128)) for i in range(64)])"
+// python3 -c "print([round(2 ** (i / 64) * 2 ** 30) for i in range(65)])"
+
+// sin over a quarter turn, Q16
+static const int32_t sin_table[257] = {
+         0,    402,    804,   1206,   1608,   2010,   2412,   2814,
+      3216,   3617,   4019,   4420,   4821,   5222,   5623,   6023,
+      6424,   6824,   7224,   7623,   8022,   8421,   8820,   9218,
+      9616,  10014,  10411,  10808,  11204,  11600,  11996,  12391,
+     12785,  13180,  13573,  13966,  14359,  14751,  15143,  15534,
+     15924,  16314,  16703,  17091,  17479,  17867,  18253,  18639,
+     19024,  19409,  19792,  20175,  20557,  20939,  21320,  21699,
+     22078,  22457,  22834,  23210,  23586,  23961,  24335,  24708,
+     25080,  25451,  25821,  26190,  26558,  26925,  27291,  27656,
+     28020,  28383,  28745,  29106,  29466,  29824,  30182,  30538,
+     30893,  31248,  31600,  31952,  32303,  32652,  33000,  33347,
+     33692,  34037,  34380,  34721,  35062,  35401,  35738,  36075,
+     36410,  36744,  37076,  37407,  37736,  38064,  38391,  38716,
+     39040,  39362,  39683,  40002,  40320,  40636,  40951,  41264,
+     41576,  41886,  42194,  42501,  42806,  43110,  43412,  43713,
+     44011,  44308,  44604,  44898,  45190,  45480,  45769,  46056,
+     46341,  46624,  46906,  47186,  47464,  47741,  48015,  48288,
+     48559,  48828,  49095,  49361,  49624,  49886,  50146,  50404,
+     50660,  50914,  51166,  51417,  51665,  51911,  52156,  52398,
+     52639,  52878,  53114,  53349,  53581,  53812,  54040,  54267,
+     54491,  54714,  54934,  55152,  55368,  55582,  55794,  56004,
+     56212,  56418,  56621,  56823,  57022,  57219,  57414,  57607,
+     57798,  57986,  58172,  58356,  58538,  58718,  58896,  59071,
+     59244,  59415,  59583,  59750,  59914,  60075,  60235,  60392,
+     60547,  60700,  60851,  60999,  61145,  61288,  61429,  61568,
+     61705,  61839,  61971,  62101,  62228,  62353,  62476,  62596,
+     62714,  62830,  62943,  63054,  63162,  63268,  63372,  63473,
+     63572,  63668,  63763,  63854,  63944,  64031,  64115,  64197,
+     64277,  64354,  64429,  64501,  64571,  64639,  64704,  64766,
+     64827,  64884,  64940,  64993,  65043,  65091,  65137,  65180,
+     65220,  65259,  65294,  65328,  65358,  65387,  65413,  65436,
+     65457,  65476,  65492,  65505,  65516,  65525,  65531,  65535,
+     65536,
+};
+
+// atan(i / 256) as an angle
+static const uint16_t atan_table[257] = {
+         0,     41,     81,    122,    163,    204,    244,    285,
+       326,    367,    407,    448,    489,    529,    570,    610,
+       651,    692,    732,    773,    813,    854,    894,    935,
+       975,   1015,   1056,   1096,   1136,   1177,   1217,   1257,
+      1297,   1337,   1377,   1417,   1457,   1497,   1537,   1577,
+      1617,   1656,   1696,   1736,   1775,   1815,   1854,   1894,
+      1933,   1973,   2012,   2051,   2090,   2129,   2168,   2207,
+      2246,   2285,   2324,   2363,   2401,   2440,   2478,   2517,
+      2555,   2594,   2632,   2670,   2708,   2746,   2784,   2822,
+      2860,   2897,   2935,   2973,   3010,   3047,   3085,   3122,
+      3159,   3196,   3233,   3270,   3307,   3344,   3380,   3417,
+      3453,   3490,   3526,   3562,   3599,   3635,   3670,   3706,
+      3742,   3778,   3813,   3849,   3884,   3920,   3955,   3990,
+      4025,   4060,   4095,   4129,   4164,   4199,   4233,   4267,
+      4302,   4336,   4370,   4404,   4438,   4471,   4505,   4539,
+      4572,   4605,   4639,   4672,   4705,   4738,   4771,   4803,
+      4836,   4869,   4901,   4933,   4966,   4998,   5030,   5062,
+      5094,   5125,   5157,   5188,   5220,   5251,   5282,   5313,
+      5344,   5375,   5406,   5437,   5467,   5498,   5528,   5559,
+      5589,   5619,   5649,   5679,   5708,   5738,   5768,   5797,
+      5826,   5856,   5885,   5914,   5943,   5972,   6000,   6029,
+      6058,   6086,   6114,   6142,   6171,   6199,   6227,   6254,
+      6282,   6310,   6337,   6365,   6392,   6419,   6446,   6473,
+      6500,   6527,   6554,   6580,   6607,   6633,   6660,   6686,
+      6712,   6738,   6764,   6790,   6815,   6841,   6867,   6892,
+      6917,   6943,   6968,   6993,   7018,   7043,   7068,   7092,
+      7117,   7141,   7166,   7190,   7214,   7238,   7262,   7286,
+      7310,   7334,   7358,   7381,   7405,   7428,   7451,   7475,
+      7498,   7521,   7544,   7566,   7589,   7612,   7635,   7657,
+      7679,   7702,   7724,   7746,   7768,   7790,   7812,   7834,
+      7856,   7877,   7899,   7920,   7942,   7963,   7984,   8005,
+      8026,   8047,   8068,   8089,   8110,   8131,   8151,   8172,
+      8192,
+};
+
+// 1 / m for m at the middle of [(64 + i) / 128, (65 + i) / 128), Q30
+static const uint32_t recip_table[64] = {
+    2130836488, 2098304633, 2066751180, 2036132644,
+    2006408080, 1977538899, 1949488702, 1922223125,
+    1895709703, 1869917734, 1844818167, 1820383490,
+    1796587627, 1773405851, 1750814694, 1728791868,
+    1707316192, 1686367527, 1665926709, 1645975491,
+    1626496491, 1607473140, 1588889636, 1570730897,
+    1552982525, 1535630765, 1518662469, 1502065065,
+    1485826524, 1469935331, 1454380460, 1439151345,
+    1424237860, 1409630292, 1395319325, 1381296015,
+    1367551776, 1354078359, 1340867839, 1327912594,
+    1315205296, 1302738895, 1290506605, 1278501893,
+    1266718465, 1255150260, 1243791434, 1232636354,
+    1221679586, 1210915890, 1200340205, 1189947649,
+    1179733506, 1169693221, 1159822392, 1150116765,
+    1140572228, 1131184802, 1121950641, 1112866020,
+    1103927337, 1095131103, 1086473940, 1077952576,
+};
+
+// 2^(i / 64), Q30
+static const uint32_t exp2_table[65] = {
+    1073741824, 1085434106, 1097253708, 1109202018,
+    1121280436, 1133490379, 1145833280, 1158310587,
+    1170923762, 1183674286, 1196563654, 1209593378,
+    1222764986, 1236080024, 1249540052, 1263146652,
+    1276901417, 1290805962, 1304861917, 1319070932,
+    1333434672, 1347954824, 1362633090, 1377471191,
+    1392470869, 1407633882, 1422962010, 1438457051,
+    1454120821, 1469955159, 1485961921, 1502142985,
+    1518500250, 1535035634, 1551751076, 1568648537,
+    1585730000, 1602997467, 1620452965, 1638098541,
+    1655936265, 1673968228, 1692196547, 1710623359,
+    1729250827, 1748081133, 1767116489, 1786359126,
+    1805811301, 1825475297, 1845353420, 1865448001,
+    1885761398, 1906295993, 1927054196, 1948038440,
+    1969251188, 1990694927, 2012372174, 2034285470,
+    2056437387, 2078830522, 2101467502, 2124350982,
+    2147483648,
+};
+
+// 1 / m in Q30, for m = n / 2^32 in [0.5, 1). Two Newton steps,
+// y = y * (2 - m * y), from the 8 correct bits of the table.
+static uint32_t recip_q30(uint32_t n)
+{
+    uint32_t y = recip_table[(n >> 25) & 63];
+    for (int k = 0; k < 2; k++) {
+        uint32_t my = (uint32_t)(((uint64_t)n * y) >> 32);
+        y = (uint32_t)(((uint64_t)y * ((2u << 30) - my)) >> 30);
+    }
+    return y;
+}
+
+q16 fx_sin(fx_angle a)
+{
+    // Mirror into the first quarter, then interpolate 1/64 of a step
+    uint32_t u = a & 0x3fff;
+    if (a & 0x4000) u = 0x4000 - u;
+    uint32_t i = u >> 6, f = u & 63;
+    q16 s = sin_table[i];
+    if (f) s += ((sin_table[i + 1] - s) * (int32_t)f) >> 6;
+    return (a & 0x8000) ? -s : s;
+}
+
+q16 fx_cos(fx_angle a)
+{
+    return fx_sin(a + 0x4000);
+}
+
+fx_angle fx_atan2(q16 y, q16 x)
+{
+    if (x == 0 && y == 0) return 0;
+    uint32_t ax = (x < 0 ? -(uint32_t)x : (uint32_t)x);
+    uint32_t ay = (y < 0 ? -(uint32_t)y : (uint32_t)y);
+
+    // Ratio of the smaller to the larger, 0 ~ 1 in Q16
+    bool steep = (ay > ax);
+    uint32_t num = (steep ? ax : ay), den = (steep ? ay : ax);
+    int sh = __builtin_clz(den);
+    uint32_t t = (uint32_t)(((uint64_t)(num << sh) * recip_q30(den << sh)) >> 46);
+    if (t > 65536) t = 65536;
+    uint32_t i = t >> 8, f = t & 255;
+    int32_t r = atan_table[i];
+    if (f) r += ((atan_table[i + 1] - r) * (int32_t)f) >> 8;
+
+    if (steep) r = 0x4000 - r;
+    if (x < 0) r = 0x8000 - r;
+    if (y < 0) r = 0x10000 - r;
+    return (fx_angle)r & 0xffff;
+}
+
+static uint32_t isqrt64(uint64_t v)
+{
+    // Digit by digit
+    uint64_t r = 0, bit = (uint64_t)1 << 62;
+    while (bit > v) bit >>= 2;
+    for (; bit; bit >>= 2) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+    }
+    return (uint32_t)r;
+}
+
+q16 fx_sqrt(q16 x)
+{
+    // The root of x * 65536 is the result in Q16
+    return (x <= 0 ? 0 : (q16)isqrt64((uint64_t)x << 16));
+}
+
+q16 fx_recip(q16 x)
+{
+    if (x == 0) return INT32_MAX;
+    uint32_t a = (x < 0 ? -(uint32_t)x : (uint32_t)x);
+    // a = m * 2^(32 - s), and 1 / x = (1 / m) * 2^(s - 16), in Q16 that
+    // is y * 2^(s - 30)
+    int s = __builtin_clz(a);
+    if (s == 31) return (x < 0 ? -INT32_MAX : INT32_MAX);
+    int64_t r = recip_q30(a << s) >> (30 - s);
+    // Newton's steps approach from below; round to nearest with the
+    // remainder of 2^32 - r * a
+    int64_t e = ((int64_t)1 << 32) - r * a;
+    while (2 * e >= (int64_t)a) { r++; e -= a; }
+    while (2 * e < -(int64_t)a) { r--; e += a; }
+    if (r > INT32_MAX) r = INT32_MAX;
+    return (x < 0 ? -(q16)r : (q16)r);
+}
+
+q16 fx_exp(q16 x)
+{
+    // e^x = 2^t with t = x * log2(e), in Q16; 2^n * 2^f for its integer
+    // and fractional parts, the latter interpolated 1/1024 of a step
+    int64_t t = ((int64_t)x * 1549082005) >> 30;
+    int32_t n = (int32_t)(t >> 16);
+    if (n >= 15) return INT32_MAX;
+    if (n < -17) return 0;
+    uint32_t f = (uint32_t)t & 0xffff, i = f >> 10, k = f & 1023;
+    uint32_t y = exp2_table[i] +
+        (uint32_t)(((uint64_t)(exp2_table[i + 1] - exp2_table[i]) * k) >> 10);
+    // Q30 to Q16, times 2^n
+    int sh = 14 - n;
+    return (q16)(sh == 0 ? y : (y + (1u << (sh - 1))) >> sh);
+}
+
+q16 fx_vlen(fx_vec a)
+{
+    uint64_t ax = (a.x < 0 ? -(int64_t)a.x : a.x);
+    uint64_t ay = (a.y < 0 ? -(int64_t)a.y : a.y);
+    uint32_t r = isqrt64(ax * ax + ay * ay);
+    return (r > INT32_MAX ? INT32_MAX : (q16)r);
+}
+
+fx_vec fx_vnorm(fx_vec a)
+{
+    q16 l = fx_vlen(a);
+    if (l == 0) return a;
+    q16 r = fx_recip(l);
+    return (fx_vec){ fx_mul(a.x, r), fx_mul(a.y, r) };
+}
+
+fx_vec fx_vrot(fx_vec a, fx_angle t)
+{
+    q16 c = fx_cos(t), s = fx_sin(t);
+    return (fx_vec){ fx_mul(a.x, c) - fx_mul(a.y, s), fx_mul(a.x, s) + fx_mul(a.y, c) };
+}
@@ -0,0 +1,90 @@
+#ifndef __MIKAN__FIXMATH_H__
+#define __MIKAN__FIXMATH_H__
+
+#include <stdint.h>
+
+// Q16 fixed-point maths with 16 fractional bits. Everything is integer
+// arithmetic on small tables, so results are the same on the board and
+// in the GLFW build, and no VFP or libm calls are made.
+//
+// Angles are fractions of a turn: 65536 is 2 * pi, and only the low 16
+// bits count.
+
+typedef int32_t q16;
+typedef uint32_t fx_angle;
+
+#define FX_ONE          65536
+#define FX(_x)          ((q16)((_x) * 65536.0 + ((_x) < 0 ? -0.5 : 0.5)))
+#define FX_TURN         65536
+#define FX_ANGLE(_deg)  ((fx_angle)((_deg) * 65536.0 / 360.0 + 0.5))
+
+static inline q16 fx_from_int(int32_t x) { return x * FX_ONE; }
+// Rounds towards negative infinity
+static inline int32_t fx_to_int(q16 x) { return x >> 16; }
+static inline int32_t fx_round(q16 x) { return (x + FX_ONE / 2) >> 16; }
+static inline float fx_to_float(q16 x) { return x * (1.0f / 65536); }
+static inline q16 fx_from_float(float x) { return (q16)(x * 65536 + (x < 0 ? -0.5f : 0.5f)); }
+
+static inline q16 fx_mul(q16 a, q16 b)
+{
+    return (q16)(((int64_t)a * b) >> 16);
+}
+
+// Exact, through a 64-bit division
+static inline q16 fx_div(q16 a, q16 b)
+{
+    return (q16)(((int64_t)a << 16) / b);
+}
+
+q16 fx_sin(fx_angle a);
+q16 fx_cos(fx_angle a);
+// Angle of (x, y) from the positive x axis, 0 ~ 65535; 0 for the origin
+fx_angle fx_atan2(q16 y, q16 x);
+// For x >= 0; exact to the last bit
+q16 fx_sqrt(q16 x);
+// 1 / x rounded to the nearest, saturating for tiny x; no
+// division
+q16 fx_recip(q16 x);
+// e^x within 2 parts in 10^5, saturating above x = 10.39
+q16 fx_exp(q16 x);
+
+typedef struct fx_vec {
+    q16 x, y;
+} fx_vec;
+
+static inline fx_vec fx_vadd(fx_vec a, fx_vec b) { return (fx_vec){ a.x + b.x, a.y + b.y }; }
+static inline fx_vec fx_vsub(fx_vec a, fx_vec b) { return (fx_vec){ a.x - b.x, a.y - b.y }; }
+static inline fx_vec fx_vscale(fx_vec a, q16 s) { return (fx_vec){ fx_mul(a.x, s), fx_mul(a.y, s) }; }
+static inline q16 fx_vdot(fx_vec a, fx_vec b)
+{
+    return (q16)(((int64_t)a.x * b.x + (int64_t)a.y * b.y) >> 16);
+}
+q16 fx_vlen(fx_vec a);
+// Unit vector along a; zero stays zero
+fx_vec fx_vnorm(fx_vec a);
+fx_vec fx_vrot(fx_vec a, fx_angle t);
+// Vector of length r at angle t
+static inline fx_vec fx_vpolar(q16 r, fx_angle t)
+{
+    return (fx_vec){ fx_mul(r, fx_cos(t)), fx_mul(r, fx_sin(t)) };
+}
+
+// Float front ends for code written with floats. The work is still done
+// in Q16, so both builds give identical results; precision is Q16's.
+static inline fx_angle fx_angle_from_rad(float rad)
+{
+    float t = rad * (float)(32768 / 3.14159265358979323846);
+    return (fx_angle)(int32_t)(t + (t < 0 ? -0.5f : 0.5f)) & 0xffff;
+}
+static inline float fxf_sin(float rad) { return fx_to_float(fx_sin(fx_angle_from_rad(rad))); }
+static inline float fxf_cos(float rad) { return fx_to_float(fx_cos(fx_angle_from_rad(rad))); }
+static inline float fxf_sqrt(float x) { return fx_to_float(fx_sqrt(fx_from_float(x))); }
+static inline float fxf_atan2(float y, float x)
+{
+    // Result in (-pi, pi], as atan2f
+    int32_t a = (int32_t)fx_atan2(fx_from_float(y), fx_from_float(x));
+    if (a > 32768) a -= 65536;
+    return a * (float)(3.14159265358979323846 / 32768);
+}
+
+#endif
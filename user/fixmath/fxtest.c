@@ -0,0 +1,56 @@
+// Host check of fixmath.c against exact results
+// cc -O2 -std=c99 fxtest.c fixmath.c -lm -o fxtest
+
+#include <math.h>
+#include <stdio.h>
+
+#include "fixmath.h"
+
+static int failures = 0;
+
+static void check_recip(q16 x)
+{
+    // Nearest to 2^32 / x, saturated
+    double e = floor(4294967296.0 / fabs((double)x) + 0.5);
+    if (e > INT32_MAX) e = INT32_MAX;
+    if (x < 0) e = -e;
+    q16 r = fx_recip(x);
+    if (r != (q16)e) {
+        printf("fx_recip(%d) = %d, expected %d\n", x, r, (q16)e);
+        failures++;
+    }
+}
+
+int main()
+{
+    // Powers of two have exact reciprocals
+    for (int i = 0; i < 31; i++) {
+        check_recip((q16)1 << i);
+        check_recip(-((q16)1 << i));
+    }
+    if (fx_recip(FX_ONE) != FX_ONE) failures++;
+    if (fx_recip(FX(2)) != FX(0.5)) failures++;
+    if (fx_recip(FX(0.5)) != FX(2)) failures++;
+
+    for (uint32_t x = 1; x < 100000; x++) check_recip(x);
+    for (uint32_t x = 1; x < INT32_MAX - 997; x += 997) {
+        check_recip(x);
+        check_recip(-(q16)x);
+    }
+    check_recip(INT32_MAX);
+    check_recip(INT32_MIN + 1);
+
+    // e^x, relative to 2 parts in 10^5 plus rounding
+    for (q16 x = FX(-12); x < FX(10.39); x += 13) {
+        double e = exp(x / 65536.0) * 65536;
+        if (fabs(fx_exp(x) - e) > e * 2e-5 + 0.5) {
+            printf("fx_exp(%d) = %d, expected %.1f\n", x, fx_exp(x), e);
+            failures++;
+        }
+    }
+    if (fx_exp(0) != FX_ONE) failures++;
+    if (fx_exp(FX(11)) != INT32_MAX) failures++;
+
+    printf("%d failure(s)\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,99 @@
+#ifndef __MIKAN__FONT_H__
+#define __MIKAN__FONT_H__
+
+#include <stdint.h>
+
+// 7x14 font for characters 32 ~ 127, shared by the kernel console and
+// applications. Each glyph row is one byte, leftmost pixel in bit 0.
+// Colours are pixel values as in gfx.h: 0xRRGGBB, or RGB565 for 16 bpp.
+
+#define FONT_W  7
+#define FONT_H  14
+
+static const uint8_t font_data[96][FONT_H] = {
+    // Generated by pack.py
+    #include "font_data.h"
+};
+
+static inline const uint8_t *font_glyph(char ch)
+{
+    uint8_t c = (uint8_t)ch;
+    return font_data[(c >= 32 && c < 128) ? c - 32 : 0];
+}
+
+// Four pixels for each nibble of a glyph row, in foreground and
+// background colours; built once per colour pair
+typedef struct font_lut {
+    uint8_t bypp;
+    uint8_t px[16][16] __attribute__((aligned(4)));
+} font_lut;
+
+static inline void font_lut_init(font_lut *l, uint32_t bpp, uint32_t fg, uint32_t bg)
+{
+    l->bypp = bpp / 8;
+    for (uint8_t n = 0; n < 16; n++)
+        for (uint8_t i = 0; i < 4; i++) {
+            uint32_t c = (n & (1 << i)) ? fg : bg;
+            for (uint8_t k = 0; k < l->bypp; k++)
+                l->px[n][i * l->bypp + k] = c >> (k * 8);
+        }
+}
+
+// The LUT's rows are read as words or halfwords
+typedef uint32_t font_word __attribute__((may_alias));
+typedef uint16_t font_half __attribute__((may_alias));
+
+// n bytes of whole pixels; by words or halfwords when the pixels allow
+static inline void font_copy(uint8_t *d, const uint8_t *s, uint32_t n, uint8_t bypp)
+{
+    if (bypp == 4 && ((uintptr_t)d & 3) == 0) {
+        for (n /= 4; n--; d += 4, s += 4) *(font_word *)d = *(const font_word *)s;
+    } else if (bypp == 2 && ((uintptr_t)d & 1) == 0) {
+        for (n /= 2; n--; d += 2, s += 2) *(font_half *)d = *(const font_half *)s;
+    } else {
+        while (n--) *d++ = *s++;
+    }
+}
+
+// Glyph with its background, two table lookups per row
+static inline void font_put(uint8_t *d, uint32_t pitch, const font_lut *l, char ch)
+{
+    const uint8_t *g = font_glyph(ch);
+    uint32_t lo = 4 * l->bypp, hi = 3 * l->bypp;
+    for (uint8_t y = 0; y < FONT_H; y++, d += pitch) {
+        font_copy(d, l->px[g[y] & 15], lo, l->bypp);
+        font_copy(d + lo, l->px[g[y] >> 4], hi, l->bypp);
+    }
+}
+
+// Foreground pixels only; empty rows cost one test
+static inline void font_put_over(uint8_t *d, uint32_t pitch, uint32_t bpp, char ch, uint32_t fg)
+{
+    const uint8_t *g = font_glyph(ch);
+    uint32_t bypp = bpp / 8;
+    for (uint8_t y = 0; y < FONT_H; y++, d += pitch)
+        for (uint32_t bits = g[y]; bits; bits &= bits - 1) {
+            uint8_t *p = d + __builtin_ctz(bits) * bypp;
+            p[0] = fg;
+            p[1] = fg >> 8;
+            if (bypp > 2) p[2] = fg >> 16;
+        }
+}
+
+// Text runs without clipping; return the width drawn
+static inline uint32_t font_text(uint8_t *d, uint32_t pitch, const font_lut *l, const char *s)
+{
+    uint32_t n = 0;
+    for (; *s; s++, n++, d += FONT_W * l->bypp) font_put(d, pitch, l, *s);
+    return n * FONT_W;
+}
+
+static inline uint32_t font_text_over(uint8_t *d, uint32_t pitch, uint32_t bpp,
+    const char *s, uint32_t fg)
+{
+    uint32_t n = 0;
+    for (; *s; s++, n++, d += FONT_W * (bpp / 8)) font_put_over(d, pitch, bpp, *s, fg);
+    return n * FONT_W;
+}
+
+#endif
@@ -0,0 +1,23 @@
+#!/usr/bin/env python3
+# Packs a 112x84 sheet of 7x14 glyphs (characters 32 ~ 127, 16 per row)
+# into one byte per glyph row, leftmost pixel in bit 0.
+# ffmpeg -f rawvideo -pix_fmt gray - -i tamzen14.png | python3 pack.py > font_data.h
+
+import sys
+
+CHAR_W, CHAR_H, COLS = 7, 14, 16
+TEX_W = CHAR_W * COLS
+
+sheet = sys.stdin.buffer.read()
+for ch in range(96):
+    tx = ch % COLS * CHAR_W
+    ty = ch // COLS * CHAR_H
+    rows = []
+    for dy in range(CHAR_H):
+        bits = 0
+        for dx in range(CHAR_W):
+            if sheet[(ty + dy) * TEX_W + tx + dx] >= 128:
+                bits |= 1 << dx
+        rows.append('0x%02x' % bits)
+    c = chr(32 + ch)
+    print('    { %s },   // %s' % (', '.join(rows), repr(c) if c != '\x7f' else 'DEL'))
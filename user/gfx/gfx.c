@@ -0,0 +1,297 @@
+#include "gfx.h"
+#include "../font/font.h"
+#include "../pix/pix.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+// Row loops of one pixel format; a primitive picks its set once and
+// calls one of them per row
+struct row_ops {
+    uint8_t bypp;
+    void (*fill)(uint8_t *d, uint32_t n, uint32_t c);
+    void (*key)(uint8_t *d, const uint8_t *s, uint32_t n, uint32_t key);
+    void (*alpha)(uint8_t *d, const uint8_t *s, uint32_t n, uint32_t a);
+};
+
+#define GFX_ROW_OPS(_bits, _type)                                               \
+static void fill##_bits(uint8_t *d, uint32_t n, uint32_t c)                     \
+{                                                                               \
+    pix_fill##_bits((_type *)d, n, c);                                          \
+}                                                                               \
+static void key##_bits(uint8_t *d, const uint8_t *s, uint32_t n, uint32_t key)  \
+{                                                                               \
+    pix_key##_bits((_type *)d, (const _type *)s, n, key);                       \
+}
+
+GFX_ROW_OPS(16, uint16_t)
+GFX_ROW_OPS(24, uint8_t)
+GFX_ROW_OPS(32, uint32_t)
+
+static void alpha16(uint8_t *d, const uint8_t *s, uint32_t n, uint32_t a)
+{
+    uint16_t *dp = (uint16_t *)d;
+    const uint16_t *sp = (const uint16_t *)s;
+    for (; n; n--, dp++, sp++) *dp = pix_blend565(*dp, *sp, a);
+}
+
+// Channels are bytes, so whole rows go through the packed kernel
+static void alpha24(uint8_t *d, const uint8_t *s, uint32_t n, uint32_t a)
+{
+    pix_blend(d, s, n * 3, a);
+}
+
+static void alpha32(uint8_t *d, const uint8_t *s, uint32_t n, uint32_t a)
+{
+    pix_blend(d, s, n * 4, a);
+}
+
+static const struct row_ops ops16 = { 2, fill16, key16, alpha16 };
+static const struct row_ops ops24 = { 3, fill24, key24, alpha24 };
+static const struct row_ops ops32 = { 4, fill32, key32, alpha32 };
+
+static inline const struct row_ops *row_ops(uint8_t bpp)
+{
+    return (bpp == 16 ? &ops16 : bpp == 32 ? &ops32 : &ops24);
+}
+
+static inline uint8_t *at(const gfx_surface *s, int x, int y, uint8_t bypp)
+{
+    return (uint8_t *)s->pixels + y * s->pitch + x * bypp;
+}
+
+static inline uint32_t get(const uint8_t *p, uint8_t bypp)
+{
+    switch (bypp) {
+        case 2: return *(const uint16_t *)p;
+        case 3: return p[0] | (p[1] << 8) | (p[2] << 16);
+        default: return *(const uint32_t *)p & 0xffffff;
+    }
+}
+
+// Clips (x, y, w, h) to the clip rectangle of s, moving (sx, sy) along;
+// false if nothing is left
+static bool clip(const gfx_surface *s, int *x, int *y, int *w, int *h, int *sx, int *sy)
+{
+    int d;
+    if ((d = s->cx1 - *x) > 0) { *x += d; *w -= d; *sx += d; }
+    if ((d = s->cy1 - *y) > 0) { *y += d; *h -= d; *sy += d; }
+    if ((d = *x + *w - s->cx2) > 0) *w -= d;
+    if ((d = *y + *h - s->cy2) > 0) *h -= d;
+    return (*w > 0 && *h > 0);
+}
+
+void gfx_init(gfx_surface *s, void *pixels, uint16_t w, uint16_t h, uint32_t pitch, uint8_t bpp)
+{
+    s->pixels = pixels;
+    s->w = w;
+    s->h = h;
+    s->pitch = pitch;
+    s->bpp = bpp;
+    s->cx1 = s->cy1 = 0;
+    s->cx2 = w;
+    s->cy2 = h;
+}
+
+void gfx_clip(gfx_surface *s, int x, int y, int w, int h)
+{
+    int sx = 0, sy = 0;
+    s->cx1 = s->cy1 = 0;
+    s->cx2 = s->w;
+    s->cy2 = s->h;
+    if (!clip(s, &x, &y, &w, &h, &sx, &sy)) x = y = w = h = 0;
+    s->cx1 = x;
+    s->cy1 = y;
+    s->cx2 = x + w;
+    s->cy2 = y + h;
+}
+
+void gfx_plot(gfx_surface *s, int x, int y, uint32_t c)
+{
+    if (x < s->cx1 || x >= s->cx2 || y < s->cy1 || y >= s->cy2) return;
+    const struct row_ops *o = row_ops(s->bpp);
+    o->fill(at(s, x, y, o->bypp), 1, c);
+}
+
+void gfx_plot_alpha(gfx_surface *s, int x, int y, uint32_t c, uint32_t a)
+{
+    if (x < s->cx1 || x >= s->cx2 || y < s->cy1 || y >= s->cy2) return;
+    const struct row_ops *o = row_ops(s->bpp);
+    uint8_t *p = at(s, x, y, o->bypp);
+    if (o->bypp == 2) {
+        *(uint16_t *)p = pix_blend565(*(uint16_t *)p, c, a);
+    } else {
+        uint8_t src[4] = { c, c >> 8, c >> 16, c >> 24 };
+        pix_blend(p, src, o->bypp, a);
+    }
+}
+
+void gfx_span(gfx_surface *s, int x, int y, int w, uint32_t c)
+{
+    gfx_rect(s, x, y, w, 1, c);
+}
+
+void gfx_rect(gfx_surface *s, int x, int y, int w, int h, uint32_t c)
+{
+    int sx = 0, sy = 0;
+    if (!clip(s, &x, &y, &w, &h, &sx, &sy)) return;
+    const struct row_ops *o = row_ops(s->bpp);
+    uint8_t *d = at(s, x, y, o->bypp);
+    for (; h > 0; h--, d += s->pitch) o->fill(d, w, c);
+}
+
+void gfx_frame(gfx_surface *s, int x, int y, int w, int h, uint32_t c)
+{
+    if (w <= 0 || h <= 0) return;
+    gfx_rect(s, x, y, w, 1, c);
+    gfx_rect(s, x, y + h - 1, w, 1, c);
+    gfx_rect(s, x, y + 1, 1, h - 2, c);
+    gfx_rect(s, x + w - 1, y + 1, 1, h - 2, c);
+}
+
+int gfx_text(gfx_surface *s, int x, int y, const char *str, uint32_t c)
+{
+    int x0 = x;
+    if (y >= s->cy2 || y + FONT_H <= s->cy1) {
+        while (*str++) x += FONT_W;
+        return x - x0;
+    }
+    const struct row_ops *o = row_ops(s->bpp);
+    for (; *str; str++, x += FONT_W) {
+        if (x >= s->cx2 || x + FONT_W <= s->cx1) continue;
+        if (x >= s->cx1 && x + FONT_W <= s->cx2 && y >= s->cy1 && y + FONT_H <= s->cy2) {
+            font_put_over(at(s, x, y, o->bypp), s->pitch, s->bpp, *str, c);
+            continue;
+        }
+        // Partly outside
+        const uint8_t *g = font_glyph(*str);
+        for (int j = 0; j < FONT_H; j++)
+            for (uint32_t bits = g[j]; bits; bits &= bits - 1)
+                gfx_plot(s, x + __builtin_ctz(bits), y + j, c);
+    }
+    return x - x0;
+}
+
+// Half widths of the rows of each disc, indexed by distance from the centre
+static uint8_t disc_half[GFX_DISC_MAX + 1][GFX_DISC_MAX + 1];
+static bool disc_ready[GFX_DISC_MAX + 1];
+
+static const uint8_t *disc_spans(int r)
+{
+    uint8_t *half = disc_half[r];
+    if (!disc_ready[r]) {
+        // x^2 + y^2 <= (r + 0.5)^2 is x^2 + y^2 <= r^2 + r for integers
+        int x = r;
+        for (int y = 0; y <= r; y++) {
+            while (x * x + y * y > r * r + r) x--;
+            half[y] = x;
+        }
+        disc_ready[r] = true;
+    }
+    return half;
+}
+
+void gfx_disc(gfx_surface *s, int cx, int cy, int r, uint32_t c)
+{
+    if (r < 0 || r > GFX_DISC_MAX) return;
+    const uint8_t *half = disc_spans(r);
+    gfx_span(s, cx - half[0], cy, half[0] * 2 + 1, c);
+    for (int y = 1; y <= r; y++) {
+        gfx_span(s, cx - half[y], cy - y, half[y] * 2 + 1, c);
+        gfx_span(s, cx - half[y], cy + y, half[y] * 2 + 1, c);
+    }
+}
+
+void gfx_blit(gfx_surface *d, int x, int y,
+    const gfx_surface *src, int sx, int sy, int w, int h, uint8_t mode, uint32_t arg)
+{
+    if (src->bpp != d->bpp) return;
+    // Keep within the source first
+    if (sx < 0) { x -= sx; w += sx; sx = 0; }
+    if (sy < 0) { y -= sy; h += sy; sy = 0; }
+    if (sx + w > src->w) w = src->w - sx;
+    if (sy + h > src->h) h = src->h - sy;
+    if (!clip(d, &x, &y, &w, &h, &sx, &sy)) return;
+
+    const struct row_ops *o = row_ops(d->bpp);
+    uint8_t *p = at(d, x, y, o->bypp);
+    const uint8_t *q = at(src, sx, sy, o->bypp);
+    for (; h > 0; h--, p += d->pitch, q += src->pitch) {
+        switch (mode) {
+            case GFX_COPY: memcpy(p, q, w * o->bypp); break;
+            case GFX_KEY: o->key(p, q, w, arg); break;
+            case GFX_ALPHA: o->alpha(p, q, w, arg); break;
+            default: return;
+        }
+    }
+}
+
+void gfx_blit_cell(gfx_surface *d, int x, int y,
+    const gfx_atlas *a, uint32_t index, uint8_t mode, uint32_t arg)
+{
+    uint32_t cols = a->s->w / a->cell_w;
+    if (cols == 0) return;
+    gfx_blit(d, x, y, a->s,
+        (index % cols) * a->cell_w, (index / cols) * a->cell_h,
+        a->cell_w, a->cell_h, mode, arg);
+}
+
+uint32_t gfx_rle_encode(gfx_rle *r, uint8_t *data, uint32_t size, uint32_t *rows,
+    const gfx_surface *src, int sx, int sy, int w, int h, uint32_t key)
+{
+    uint8_t bypp = src->bpp / 8;
+    uint32_t n = 0;
+    for (int j = 0; j < h; j++) {
+        const uint8_t *p = at(src, sx, sy + j, bypp);
+        rows[j] = n;
+        for (int i = 0; ; ) {
+            // A skip of 255 may be followed by an empty run; only the
+            // terminator has both zero
+            int skip = 0, count = 0;
+            while (i < w && skip < 255 && get(p + i * bypp, bypp) == key) { i++; skip++; }
+            while (i + count < w && count < 255 && get(p + (i + count) * bypp, bypp) != key)
+                count++;
+            // Trailing transparent pixels need no run
+            if (count == 0 && i == w) break;
+            if (n + 2 + count * bypp + 2 > size) return 0;
+            data[n++] = skip;
+            data[n++] = count;
+            memcpy(data + n, p + i * bypp, count * bypp);
+            n += count * bypp;
+            i += count;
+        }
+        if (n + 2 > size) return 0;
+        data[n++] = 0;
+        data[n++] = 0;
+    }
+    r->w = w;
+    r->h = h;
+    r->bpp = src->bpp;
+    r->data = data;
+    r->rows = rows;
+    return n;
+}
+
+void gfx_rle_draw(gfx_surface *d, int x, int y, const gfx_rle *r)
+{
+    if (r->bpp != d->bpp) return;
+    uint8_t bypp = d->bpp / 8;
+    int j0 = (d->cy1 > y ? d->cy1 - y : 0);
+    int j1 = (d->cy2 < y + r->h ? d->cy2 - y : r->h);
+    for (int j = j0; j < j1; j++) {
+        const uint8_t *q = r->data + r->rows[j];
+        uint8_t *row = (uint8_t *)d->pixels + (y + j) * d->pitch;
+        for (int i = x; q[0] | q[1]; ) {
+            uint8_t count = q[1];
+            i += q[0];
+            q += 2;
+            // Runs only move right
+            if (i >= d->cx2) break;
+            int a = (i < d->cx1 ? d->cx1 : i);
+            int b = (i + count > d->cx2 ? d->cx2 : i + count);
+            if (a < b) memcpy(row + a * bypp, q + (a - i) * bypp, (b - a) * bypp);
+            q += count * bypp;
+            i += count;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef __MIKAN__GFX_H__
+#define __MIKAN__GFX_H__
+
+#include <stdint.h>
+
+// 2D drawing into application buffers. Primitives are clipped once and
+// then handed to row loops specialised for 16, 24 and 32 bpp, so nothing
+// is checked per pixel. Colours are pixel values: 0xRRGGBB stored as
+// [B, G, R(, X)] for 24/32 bpp, RGB565 for 16 bpp.
+
+typedef struct gfx_surface {
+    void *pixels;
+    uint16_t w, h;
+    uint32_t pitch;         // Bytes per row
+    uint8_t bpp;            // 16, 24 or 32
+    int16_t cx1, cy1, cx2, cy2; // Clip rectangle, right/bottom exclusive
+} gfx_surface;
+
+void gfx_init(gfx_surface *s, void *pixels, uint16_t w, uint16_t h, uint32_t pitch, uint8_t bpp);
+// Limits drawing to a rectangle within the surface; gfx_init() resets it
+void gfx_clip(gfx_surface *s, int x, int y, int w, int h);
+
+void gfx_plot(gfx_surface *s, int x, int y, uint32_t c);
+// Pixel moved towards c by a / 256, a = 0 ~ 256
+void gfx_plot_alpha(gfx_surface *s, int x, int y, uint32_t c, uint32_t a);
+void gfx_span(gfx_surface *s, int x, int y, int w, uint32_t c);
+void gfx_rect(gfx_surface *s, int x, int y, int w, int h, uint32_t c);
+// Rectangle outline, one pixel wide
+void gfx_frame(gfx_surface *s, int x, int y, int w, int h, uint32_t c);
+
+// Filled circle of radius r up to GFX_DISC_MAX; a pixel is inside when
+// its centre is within r + 0.5. Spans of each radius are computed once.
+#define GFX_DISC_MAX    63
+void gfx_disc(gfx_surface *s, int cx, int cy, int r, uint32_t c);
+
+// Text in the 7x14 font of font.h, foreground pixels only; a whole
+// string per call. Returns the width drawn.
+int gfx_text(gfx_surface *s, int x, int y, const char *str, uint32_t c);
+
+#define GFX_COPY    0
+#define GFX_KEY     1       // arg is the transparent colour
+#define GFX_ALPHA   2       // arg is the alpha, 0 ~ 256
+// Copies w * h pixels at (sx, sy) of src; both surfaces share a depth
+void gfx_blit(gfx_surface *d, int x, int y,
+    const gfx_surface *src, int sx, int sy, int w, int h, uint8_t mode, uint32_t arg);
+
+// Equally sized cells laid out left to right, top to bottom
+typedef struct gfx_atlas {
+    const gfx_surface *s;
+    uint16_t cell_w, cell_h;
+} gfx_atlas;
+void gfx_blit_cell(gfx_surface *d, int x, int y,
+    const gfx_atlas *a, uint32_t index, uint8_t mode, uint32_t arg);
+
+// Sprites with transparent runs removed. Each row is a sequence of
+// [skip, count, count pixels] terminated by a zero count; rows[] holds
+// the offset of every row, so clipped rows are skipped without decoding.
+typedef struct gfx_rle {
+    uint16_t w, h;
+    uint8_t bpp;
+    const uint8_t *data;
+    const uint32_t *rows;
+} gfx_rle;
+// Encodes w * h pixels at (sx, sy) of src, pixels equal to key being left
+// out, into data (size bytes) and rows (h entries). Returns the number of
+// bytes used, or 0 if data is too small.
+uint32_t gfx_rle_encode(gfx_rle *r, uint8_t *data, uint32_t size, uint32_t *rows,
+    const gfx_surface *src, int sx, int sy, int w, int h, uint32_t key);
+void gfx_rle_draw(gfx_surface *d, int x, int y, const gfx_rle *r);
+
+#endif
@@ -1,2 +1,2 @@
 #!/bin/sh
-arm-none-eabi-gcc -mfpu=vfp -mfloat-abi=hard -march=armv6k -mtune=arm1176jzf-s -nostartfiles -Wl,-T,link.ld -std=c99 -O2 api_bare.c ovo.c -lm
+arm-none-eabi-gcc -mfpu=vfp -mfloat-abi=hard -march=armv6k -mtune=arm1176jzf-s -nostartfiles -Wl,-T,link.ld -std=c99 -O2 api_bare.c ../fixmath/fixmath.c ../gfx/gfx.c ovo.c
@@ -1,2 +1,2 @@
 #!/bin/sh
-gcc api_glfw.c ovo.c -framework OpenGL -lGLFW -lglew -O2 -std=c99
+gcc api_glfw.c ../fixmath/fixmath.c ../gfx/gfx.c ovo.c -framework OpenGL -lGLFW -lglew -O2 -std=c99
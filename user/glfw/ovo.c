@@ -1,23 +1,18 @@
 #include "api.h"
+#include "../fixmath/fixmath.h"
+#include "../gfx/gfx.h"
 
-#include <math.h>
 #include <string.h>
 
-#ifndef M_PI
-#define M_PI  3.1415926535897932384626433832795
-#endif
 #ifndef M_SQRT1_2
 #define M_SQRT1_2   0.7071067811865476
 #endif
 
 static uint8_t buf[256][256][3];
+static gfx_surface scr;
 
-static inline void pix(uint8_t x, uint8_t y, uint8_t r, uint8_t g, uint8_t b)
-{
-    buf[y][x][0] = r;
-    buf[y][x][1] = g;
-    buf[y][x][2] = b;
-}
+// buf holds [R, G, B]
+#define RGB(r, g, b)    (((b) << 16) | ((g) << 8) | (r))
 
 static float p0[2];
 static float v0[2];
@@ -26,9 +21,12 @@ static int T = 0;
 
 static inline void recal_p()
 {
-    float phase = T * M_PI / 240;
-    float r = 32 * (1.5f + sinf(phase * 1.96f));
-    float x = r * cosf(phase), y = r * sinf(phase);
+    // A turn every 480 ticks, and 1.96 turns for the radius
+    fx_angle phase = (T % 480) * FX_TURN / 480;
+    fx_angle phase2 = (T % 12000) * 49 % 12000 * FX_TURN / 12000;
+    q16 r = 32 * (FX(1.5) + fx_sin(phase2));
+    float x = fx_to_float(fx_mul(r, fx_cos(phase)));
+    float y = fx_to_float(fx_mul(r, fx_sin(phase)));
     p[0][0] = (int)(p0[0] + 0.5f);
     p[0][1] = (int)(p0[1] + 0.5f);
     p[1][0] = (int)(p0[0] + x); p[1][1] = (int)(p0[1] + y);
@@ -43,6 +41,7 @@ void init()
     recal_p();
     memcpy(q, p, sizeof q);
     memset(buf, 0, sizeof buf);
+    gfx_init(&scr, buf, 256, 256, 256 * 3, 24);
 }
 
 void update()
@@ -72,27 +71,22 @@ void update()
 
 static inline void blit(uint8_t i)
 {
-    int x0, y0;
-    for (int x = -8; x <= 8; x++) if ((x0 = q[i][0] + x) >= 0 && x0 < 256)
-    for (int y = -8; y <= 8; y++) if ((y0 = q[i][1] + y) >= 0 && y0 < 256) {
-        if (x * x + y * y > (int)(8.5f * 8.5f)) continue;
-
-        static const uint32_t button[4] = {
-            BUTTON_TRI, BUTTON_CIR, BUTTON_CRO, BUTTON_SQR
-        };
-        uint8_t r1 = 240, g1 = 192, b1 = 108;
-        uint8_t r2 = 128, g2 = 96, b2 = 32;
-        if (i == 0) {
-            g1 = 144;
-            g2 = 48;
-        } else if (buttons() & button[i - 1]) {
-            r1 = 192, g1 = 240;
-            r2 = 96, g2 = 128;
-        }
-        if (y0 > 0) pix(x0, y0 + 1, r2, g2, b2);
-        if (x0 < 255) pix(x0 + 1, y0, r2, g2, b2);
-        pix(x0, y0, r1, g1, b1);
+    static const uint32_t button[4] = {
+        BUTTON_TRI, BUTTON_CIR, BUTTON_CRO, BUTTON_SQR
+    };
+    uint8_t r1 = 240, g1 = 192, b1 = 108;
+    uint8_t r2 = 128, g2 = 96, b2 = 32;
+    if (i == 0) {
+        g1 = 144;
+        g2 = 48;
+    } else if (buttons() & button[i - 1]) {
+        r1 = 192, g1 = 240;
+        r2 = 96, g2 = 128;
     }
+    // Shadow one pixel down and right, under the disc
+    gfx_disc(&scr, q[i][0], q[i][1] + 1, 8, RGB(r2, g2, b2));
+    gfx_disc(&scr, q[i][0] + 1, q[i][1], 8, RGB(r2, g2, b2));
+    gfx_disc(&scr, q[i][0], q[i][1], 8, RGB(r1, g1, b1));
 }
 
 void *draw()
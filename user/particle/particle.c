@@ -0,0 +1,108 @@
+#include "particle.h"
+
+static void free_bucket(particles *p, uint32_t tick)
+{
+    int16_t *head = &p->bucket[tick & (PARTICLE_LIFE_MAX - 1)];
+    while (*head >= 0) {
+        particle_batch *b = &p->batch[*head];
+        int16_t next = b->next;
+        b->count = 0;
+        b->next = p->free;
+        p->free = *head;
+        *head = next;
+    }
+}
+
+void particles_init(particles *p, uint32_t now)
+{
+    p->now = now;
+    p->free = 0;
+    for (int16_t i = 0; i < PARTICLE_BATCHES; i++) {
+        p->batch[i].count = 0;
+        p->batch[i].next = (i + 1 < PARTICLE_BATCHES ? i + 1 : -1);
+    }
+    for (uint32_t i = 0; i < PARTICLE_LIFE_MAX; i++) p->bucket[i] = -1;
+}
+
+bool particle_add(particles *p, int32_t x, int32_t y, int32_t vx, int32_t vy,
+    int32_t damp, uint32_t life, uint32_t colour)
+{
+    if (life == 0 || life >= PARTICLE_LIFE_MAX) return false;
+    uint32_t death = p->now + life;
+    int16_t *head = &p->bucket[death & (PARTICLE_LIFE_MAX - 1)];
+    // The batch at the head of a bucket is the only one with room
+    if (*head < 0 || p->batch[*head].count == PARTICLE_BATCH) {
+        if (p->free < 0) return false;
+        int16_t i = p->free;
+        particle_batch *b = &p->batch[i];
+        p->free = b->next;
+        b->death = death;
+        b->next = *head;
+        *head = i;
+    }
+    particle_batch *b = &p->batch[*head];
+    uint16_t i = b->count++;
+    b->x[i] = x;
+    b->y[i] = y;
+    b->vx[i] = vx;
+    b->vy[i] = vy;
+    b->damp[i] = damp;
+    b->fade[i] = (255 << 16) / life;
+    b->colour[i] = colour;
+    return true;
+}
+
+static void integrate(particle_batch *b)
+{
+    uint16_t n = b->count;
+    for (uint16_t i = 0; i < n; i++) {
+        b->x[i] += b->vx[i];
+        b->y[i] += b->vy[i];
+        b->vx[i] = ((int64_t)b->vx[i] * b->damp[i]) >> 16;
+        b->vy[i] = ((int64_t)b->vy[i] * b->damp[i]) >> 16;
+    }
+}
+
+void particles_update(particles *p, uint32_t now)
+{
+    if (now - p->now >= PARTICLE_LIFE_MAX) {
+        particles_init(p, now);
+        return;
+    }
+    while (p->now != now) {
+        free_bucket(p, ++p->now);
+        for (uint16_t i = 0; i < PARTICLE_BATCHES; i++)
+            if (p->batch[i].count) integrate(&p->batch[i]);
+    }
+}
+
+void particles_draw(const particles *p, gfx_surface *s)
+{
+    for (uint16_t i = 0; i < PARTICLE_BATCHES; i++) {
+        const particle_batch *b = &p->batch[i];
+        uint32_t left = b->death - p->now;
+        for (uint16_t j = 0; j < b->count; j++)
+            gfx_plot_alpha(s, b->x[j] >> 16, b->y[j] >> 16, b->colour[j],
+                (left * b->fade[j]) >> 16);
+    }
+}
+
+bool particles_bounds(const particles *p, int *x1, int *y1, int *x2, int *y2)
+{
+    int32_t xmin = INT32_MAX, ymin = INT32_MAX, xmax = INT32_MIN, ymax = INT32_MIN;
+    for (uint16_t i = 0; i < PARTICLE_BATCHES; i++) {
+        const particle_batch *b = &p->batch[i];
+        for (uint16_t j = 0; j < b->count; j++) {
+            if (xmin > b->x[j]) xmin = b->x[j];
+            if (xmax < b->x[j]) xmax = b->x[j];
+            if (ymin > b->y[j]) ymin = b->y[j];
+            if (ymax < b->y[j]) ymax = b->y[j];
+        }
+    }
+    if (xmin > xmax) return false;
+    *x1 = xmin >> 16;
+    *y1 = ymin >> 16;
+    *x2 = (xmax >> 16) + 1;
+    *y2 = (ymax >> 16) + 1;
+    return true;
+}
@@ -0,0 +1,52 @@
+#ifndef __MIKAN__PARTICLE_H__
+#define __MIKAN__PARTICLE_H__
+
+#include "../gfx/gfx.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Particles in fixed-point Q16 (16 fractional bits), stored as arrays of
+// fields in batches. Particles of a batch die on the same tick, and
+// batches are bucketed by that tick, so expiry frees whole batches.
+//
+// Each tick, a particle moves by its velocity, then the velocity is
+// multiplied by damp: with damp = d and v0 = D * (1 - d), the particle
+// ends up at D * (1 - d^n) after n ticks.
+
+#define PARTICLE_BATCH      64
+#define PARTICLE_BATCHES    128
+#define PARTICLE_LIFE_MAX   256     // Ticks; a power of 2
+
+typedef struct particle_batch {
+    uint32_t death;
+    uint16_t count;
+    int16_t next;           // In the same bucket, or in the free list
+    int32_t x[PARTICLE_BATCH], y[PARTICLE_BATCH];
+    int32_t vx[PARTICLE_BATCH], vy[PARTICLE_BATCH];
+    int32_t damp[PARTICLE_BATCH];
+    uint32_t fade[PARTICLE_BATCH];  // Alpha per remaining tick, Q16
+    uint32_t colour[PARTICLE_BATCH];
+} particle_batch;
+
+typedef struct particles {
+    uint32_t now;
+    int16_t free;
+    int16_t bucket[PARTICLE_LIFE_MAX];
+    particle_batch batch[PARTICLE_BATCHES];
+} particles;
+
+// Removes every particle and sets the current tick
+void particles_init(particles *p, uint32_t now);
+// life is in ticks, 1 ~ PARTICLE_LIFE_MAX - 1; the particle starts at
+// full alpha and fades out linearly. False when out of batches.
+bool particle_add(particles *p, int32_t x, int32_t y, int32_t vx, int32_t vy,
+    int32_t damp, uint32_t life, uint32_t colour);
+// Advances to tick now, freeing expired batches and moving the rest
+void particles_update(particles *p, uint32_t now);
+void particles_draw(const particles *p, gfx_surface *s);
+// Pixels particles_draw() may touch, as [x1, x2) x [y1, y2); false when
+// there are no particles
+bool particles_bounds(const particles *p, int *x1, int *y1, int *x2, int *y2);
+
+#endif
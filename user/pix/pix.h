@@ -0,0 +1,245 @@
+#ifndef __MIKAN__PIX_H__
+#define __MIKAN__PIX_H__
+
+#include <stdint.h>
+
+// Pixel kernels working on four bytes at a time, shared by the kernel and
+// applications. Byte-wise operations do not care about the pixel format;
+// ARMv6 SIMD instructions are used where available, SWAR otherwise.
+
+#if defined(__ARM_FEATURE_SIMD32)
+
+static inline uint32_t pix_uqadd8(uint32_t a, uint32_t b)
+{
+    uint32_t r;
+    __asm__ ("uqadd8 %0, %1, %2" : "=r" (r) : "r" (a), "r" (b));
+    return r;
+}
+
+static inline uint32_t pix_uqsub8(uint32_t a, uint32_t b)
+{
+    uint32_t r;
+    __asm__ ("uqsub8 %0, %1, %2" : "=r" (r) : "r" (a), "r" (b));
+    return r;
+}
+
+static inline uint32_t pix_uhadd8(uint32_t a, uint32_t b)
+{
+    uint32_t r;
+    __asm__ ("uhadd8 %0, %1, %2" : "=r" (r) : "r" (a), "r" (b));
+    return r;
+}
+
+// Bytes 0 and 2, and bytes 1 and 3, zero-extended to halfwords
+static inline uint32_t pix_even(uint32_t a)
+{
+    uint32_t r;
+    __asm__ ("uxtb16 %0, %1" : "=r" (r) : "r" (a));
+    return r;
+}
+
+static inline uint32_t pix_odd(uint32_t a)
+{
+    uint32_t r;
+    __asm__ ("uxtb16 %0, %1, ror #8" : "=r" (r) : "r" (a));
+    return r;
+}
+
+// Halfwords of a that differ from those of b are taken, others from c
+static inline uint32_t pix_sel16_ne(uint32_t a, uint32_t b, uint32_t c)
+{
+    uint32_t r, t;
+    // GE flags are set for halfwords of a ^ b that are at least 1
+    __asm__ ("usub16 %1, %2, %3\n\t"
+             "sel %0, %4, %5"
+        : "=r" (r), "=&r" (t)
+        : "r" (a ^ b), "r" (0x00010001), "r" (a), "r" (c));
+    return r;
+}
+
+#else
+
+static inline uint32_t pix_uqadd8(uint32_t a, uint32_t b)
+{
+    uint32_t t = ((a & 0x7f7f7f7f) + (b & 0x7f7f7f7f)) ^ ((a ^ b) & 0x80808080);
+    uint32_t c = ((a & b) | ((a | b) & ~t)) & 0x80808080;
+    return t | ((c >> 7) * 0xff);
+}
+
+static inline uint32_t pix_uqsub8(uint32_t a, uint32_t b)
+{
+    uint32_t t = ((a | 0x80808080) - (b & 0x7f7f7f7f)) ^ ((a ^ ~b) & 0x80808080);
+    uint32_t c = ((~a & b) | (~(a ^ b) & t)) & 0x80808080;
+    return t & ~((c >> 7) * 0xff);
+}
+
+static inline uint32_t pix_uhadd8(uint32_t a, uint32_t b)
+{
+    return (a & b) + (((a ^ b) & 0xfefefefe) >> 1);
+}
+
+static inline uint32_t pix_even(uint32_t a) { return a & 0x00ff00ff; }
+static inline uint32_t pix_odd(uint32_t a) { return (a >> 8) & 0x00ff00ff; }
+
+static inline uint32_t pix_sel16_ne(uint32_t a, uint32_t b, uint32_t c)
+{
+    uint32_t x = a ^ b, m = 0;
+    if (x & 0x0000ffff) m |= 0x0000ffff;
+    if (x & 0xffff0000) m |= 0xffff0000;
+    return (a & m) | (c & ~m);
+}
+
+#endif
+
+// Each byte scaled by s / 256, s = 0 ~ 256
+static inline uint32_t pix_scale_word(uint32_t a, uint32_t s)
+{
+    return (((pix_even(a) * s) >> 8) & 0x00ff00ff) | ((pix_odd(a) * s) & 0xff00ff00);
+}
+
+// Each byte moved from a towards b by alpha / 256, alpha = 0 ~ 256
+static inline uint32_t pix_blend_word(uint32_t a, uint32_t b, uint32_t alpha)
+{
+    uint32_t ia = 256 - alpha;
+    uint32_t e = ((pix_even(a) * ia + pix_even(b) * alpha) >> 8) & 0x00ff00ff;
+    uint32_t o = (pix_odd(a) * ia + pix_odd(b) * alpha) & 0xff00ff00;
+    return e | o;
+}
+
+// RGB565 pixel moved from d towards s by alpha / 256, channel by channel
+static inline uint16_t pix_blend565(uint16_t d, uint16_t s, uint32_t alpha)
+{
+    int32_t dr = d >> 11, dg = (d >> 5) & 63, db = d & 31;
+    int32_t sr = s >> 11, sg = (s >> 5) & 63, sb = s & 31;
+    dr += ((sr - dr) * (int32_t)alpha) >> 8;
+    dg += ((sg - dg) * (int32_t)alpha) >> 8;
+    db += ((sb - db) * (int32_t)alpha) >> 8;
+    return (dr << 11) | (dg << 5) | db;
+}
+
+// The loops below take byte counts. Bytes up to the first word boundary
+// of d, and the tail, go one at a time; so does everything when s is
+// aligned differently from d.
+
+#define PIX_BYTEWISE(_d, _s, _n, _word, _byte) do {                             \
+    while (((uintptr_t)(_d) & 3) && (_n)) { _byte; (_d)++; (_s)++; (_n)--; }    \
+    if (((uintptr_t)(_s) & 3) == 0) {                                           \
+        uint32_t *_dw = (uint32_t *)(_d);                                       \
+        const uint32_t *_sw = (const uint32_t *)(_s);                           \
+        for (; (_n) >= 4; (_n) -= 4, _dw++, _sw++) { _word; }                   \
+        (_d) = (uint8_t *)_dw; (_s) = (const uint8_t *)_sw;                     \
+    }                                                                           \
+    for (; (_n); (_n)--, (_d)++, (_s)++) { _byte; }                             \
+} while (0)
+
+// d = min(d + s, 255)
+static inline void pix_add(uint8_t *d, const uint8_t *s, uint32_t n)
+{
+    PIX_BYTEWISE(d, s, n,
+        *_dw = pix_uqadd8(*_dw, *_sw),
+        *d = (*d + *s > 255 ? 255 : *d + *s));
+}
+
+// d = max(d - s, 0)
+static inline void pix_sub(uint8_t *d, const uint8_t *s, uint32_t n)
+{
+    PIX_BYTEWISE(d, s, n,
+        *_dw = pix_uqsub8(*_dw, *_sw),
+        *d = (*d > *s ? *d - *s : 0));
+}
+
+// d = (d + s) / 2
+static inline void pix_avg(uint8_t *d, const uint8_t *s, uint32_t n)
+{
+    PIX_BYTEWISE(d, s, n,
+        *_dw = pix_uhadd8(*_dw, *_sw),
+        *d = (*d + *s) >> 1);
+}
+
+// d += (s - d) * alpha / 256, alpha = 0 ~ 256
+static inline void pix_blend(uint8_t *d, const uint8_t *s, uint32_t n, uint32_t alpha)
+{
+    PIX_BYTEWISE(d, s, n,
+        *_dw = pix_blend_word(*_dw, *_sw, alpha),
+        *d = (*d * (256 - alpha) + *s * alpha) >> 8);
+}
+
+// d = d * s / 256, s = 0 ~ 256; fades and darkening
+static inline void pix_scale(uint8_t *d, uint32_t n, uint32_t s)
+{
+    const uint8_t *p = d;
+    PIX_BYTEWISE(d, p, n,
+        *_dw = pix_scale_word(*_dw, s),
+        *d = (*d * s) >> 8);
+}
+
+// Pattern of four pixels in three words, in memory order [B, G, R]
+static inline void pix_pattern24(uint32_t c, uint32_t w[3])
+{
+    uint32_t b = c & 0xff, g = (c >> 8) & 0xff, r = (c >> 16) & 0xff;
+    uint32_t p = b | (g << 8) | (r << 16);
+    w[0] = p | (b << 24);
+    w[1] = g | (r << 8) | (b << 16) | (g << 24);
+    w[2] = r | (p << 8);
+}
+
+// Fills count pixels; colours are 0xRRGGBB, or RGB565 for 16 bpp
+static inline void pix_fill16(uint16_t *d, uint32_t count, uint16_t c)
+{
+    if (((uintptr_t)d & 2) && count) { *d++ = c; count--; }
+    uint32_t *dw = (uint32_t *)d, cw = c | ((uint32_t)c << 16);
+    for (; count >= 2; count -= 2) *dw++ = cw;
+    if (count) *(uint16_t *)dw = c;
+}
+
+static inline void pix_fill24(uint8_t *d, uint32_t count, uint32_t c)
+{
+    uint8_t b = c & 0xff, g = (c >> 8) & 0xff, r = (c >> 16) & 0xff;
+    // Four pixels make three words
+    while (((uintptr_t)d & 3) && count) { d[0] = b; d[1] = g; d[2] = r; d += 3; count--; }
+    uint32_t w[3];
+    pix_pattern24(c, w);
+    uint32_t *dw = (uint32_t *)d;
+    for (; count >= 4; count -= 4, dw += 3) { dw[0] = w[0]; dw[1] = w[1]; dw[2] = w[2]; }
+    for (d = (uint8_t *)dw; count; count--, d += 3) { d[0] = b; d[1] = g; d[2] = r; }
+}
+
+static inline void pix_fill32(uint32_t *d, uint32_t count, uint32_t c)
+{
+    for (; count >= 4; count -= 4, d += 4) { d[0] = d[1] = d[2] = d[3] = c; }
+    for (; count; count--) *d++ = c;
+}
+
+// Copies the pixels of s that differ from key
+static inline void pix_key16(uint16_t *d, const uint16_t *s, uint32_t count, uint16_t key)
+{
+    if (((uintptr_t)d & 2) == ((uintptr_t)s & 2)) {
+        if (((uintptr_t)d & 2) && count) {
+            if (*s != key) *d = *s;
+            d++; s++; count--;
+        }
+        uint32_t *dw = (uint32_t *)d, kw = key | ((uint32_t)key << 16);
+        const uint32_t *sw = (const uint32_t *)s;
+        // Two pixels per word
+        for (; count >= 2; count -= 2, dw++, sw++)
+            *dw = pix_sel16_ne(*sw, kw, *dw);
+        d = (uint16_t *)dw; s = (const uint16_t *)sw;
+    }
+    for (; count; count--, d++, s++) if (*s != key) *d = *s;
+}
+
+static inline void pix_key24(uint8_t *d, const uint8_t *s, uint32_t count, uint32_t key)
+{
+    uint8_t b = key & 0xff, g = (key >> 8) & 0xff, r = (key >> 16) & 0xff;
+    for (; count; count--, d += 3, s += 3)
+        if (s[0] != b || s[1] != g || s[2] != r) { d[0] = s[0]; d[1] = s[1]; d[2] = s[2]; }
+}
+
+// The top byte is not compared
+static inline void pix_key32(uint32_t *d, const uint32_t *s, uint32_t count, uint32_t key)
+{
+    for (; count; count--, d++, s++)
+        if (((*s ^ key) & 0xffffff) != 0) *d = *s;
+}
+
+#endif
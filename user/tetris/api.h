@@ -22,6 +22,144 @@ void register_loop(update_func_t update, draw_func_t draw);
 
 uint32_t buttons();
 
+// Display mode, to be requested in init(); buffers returned from draw()
+// are then expected to be width * height pixels, tightly packed.
+// Returns 0 if the mode is not supported.
+#define PIXEL_ORDER_BGR 0
+#define PIXEL_ORDER_RGB 1
+uint32_t display_mode(uint32_t width, uint32_t height, uint32_t bpp, uint32_t order);
+// Size of the screen the mode is scaled up to, as width | (height << 16)
+uint32_t display_size();
+
+// 16 bpp pixels are RGB565 regardless of the pixel order; rows of 2-byte
+// pixels keep word alignment, and take 2/3 of the memory bandwidth
+typedef uint16_t rgb565;
+#define RGB565(r, g, b) \
+    ((rgb565)((((r) & 0xf8) << 8) | (((g) & 0xfc) << 3) | ((b) >> 3)))
+
+// For applications still drawing 24-bit [B, G, R] pixels
+static inline void bgr888_to_rgb565(rgb565 *dst, const uint8_t *src, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++, src += 3)
+        dst[i] = RGB565(src[2], src[1], src[0]);
+}
+static inline void rgb565_to_bgr888(uint8_t *dst, const rgb565 *src, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++, dst += 3) {
+        // Replicate the top bits so that white stays white
+        uint8_t r = src[i] >> 11, g = (src[i] >> 5) & 63, b = src[i] & 31;
+        dst[0] = (b << 3) | (b >> 2);
+        dst[1] = (g << 2) | (g >> 4);
+        dst[2] = (r << 3) | (r >> 2);
+    }
+}
+
+// The framebuffer slice that will be shown next; valid until draw() returns.
+// Returning it from draw() skips the copy, but the whole frame must be
+// redrawn since the slice holds an older frame. NULL when the
+// framebuffer's rows are not tightly packed; draw elsewhere then.
+void *back_buffer();
+
+// Regions changed since the previous frame; call during draw().
+// Without any report the whole frame is presented.
+typedef struct damage_rect {
+    uint16_t x, y, w, h;
+} damage_rect;
+void damage(const damage_rect *rects, uint32_t count);
+
+#define SWAP_LOW_LATENCY    0   // Newest frame wins; use with 2 buffers
+#define SWAP_THROUGHPUT     1   // Every frame is shown in order; 3~4 buffers
+void swap_policy(uint32_t policy, uint32_t count);
+
+#define FRAMES_PRESENTED    0
+#define FRAMES_FLIPPED      1
+#define FRAMES_DROPPED      2
+#define FRAMES_REPEATED     3
+#define FRAMES_UPDATED      4
+#define FRAMES_SKIPPED      5   // draw() calls left out to keep up
+#define FRAMES_LOST         6   // Ticks beyond the catch-up bound
+uint32_t frame_counter(uint32_t which);
+
+// update() runs at a fixed 60 Hz; when behind, up to max_catchup updates
+// run back to back and up to max_skip draws in a row are left out
+void schedule(uint32_t max_catchup, uint32_t max_skip);
+
+// Timing of the last 128 frames in microseconds
+#define TIME_WAIT       0
+#define TIME_UPDATE     1
+#define TIME_DRAW       2
+#define TIME_PRESENT    3
+#define TIME_FRAME      4
+#define TIME_MIN        0
+#define TIME_AVG        1
+#define TIME_P99        2
+#define TIME_MAX        3
+#define TIME_OVERRUNS   4   // Since start, not limited to recent frames
+uint32_t frame_time(uint32_t phase, uint32_t stat);
+void frame_time_overlay(uint32_t on);
+
+// Layers composited while presenting. Layer 0 is a full-screen opaque
+// background replacing draw()'s buffer, which may then be NULL; it is
+// cached, so set it again after changing its pixels. Layers 1~3 are
+// blended on top within their rectangles. damage() must cover whatever
+// changes in them. Layers are reset by display_mode().
+#define LAYER_OPAQUE    1
+#define LAYER_KEY       2   // Pixels equal to key are transparent
+#define LAYER_ALPHA     3   // Constant alpha
+#define LAYER_FILL      4   // Solid key colour at constant alpha; no pixels
+typedef struct layer_desc {
+    const void *pixels;     // w * h pixels at the current depth
+    uint16_t x, y, w, h;
+    uint8_t mode;
+    uint8_t alpha;          // 0 ~ 255
+    uint32_t key;           // Pixel value, e.g. 0xRRGGBB or RGB565()
+} layer_desc;
+uint32_t layer(uint32_t index, const layer_desc *desc);
+
+// Files on the SD card, by path from its root. Failures are negative
+// FatFs result codes (e.g. -4 for no file). Whole sectors read into
+// 32-byte aligned buffers come from the card without copying, so read
+// large assets in one call into an aligned buffer.
+//
+// Writes are held in memory and reach the card after the frame is
+// presented, so saving from update() does not stall; file_sync() waits
+// for the card instead.
+#define FILE_READ       0x01
+#define FILE_WRITE      0x02
+#define FILE_CREATE     0x08    // Created, or truncated if it exists
+#define FILE_APPEND     0x30    // Created if needed, positioned at the end
+#define FILE_NAME_MAX   256
+typedef struct file_info {
+    uint32_t size;
+    uint8_t dir;
+    char name[FILE_NAME_MAX];
+} file_info;
+// Returns a handle; up to 8 files and directories may be open
+int32_t file_open(const char *path, uint32_t mode);
+int32_t file_close(int32_t fd);
+// Returns the number of bytes read, less than len only at the end
+int32_t file_read(int32_t fd, void *buf, uint32_t len);
+// Returns the number of bytes written, fewer only when the card is full
+int32_t file_write(int32_t fd, const void *buf, uint32_t len);
+int32_t file_sync(int32_t fd);
+int32_t file_seek(int32_t fd, uint32_t offs);
+int32_t file_stat(const char *path, file_info *info);
+int32_t dir_open(const char *path);
+// Returns 1 with the next entry in info, 0 after the last; close with
+// file_close()
+int32_t dir_read(int32_t fd, file_info *info);
+
+// Counters of the card and its cache since mount; DISK_ERRORS counts
+// failed card commands, including writes held back from file_write()
+#define DISK_HITS           0
+#define DISK_MISSES         1
+#define DISK_READS          2
+#define DISK_BYTES_READ     3
+#define DISK_WRITES         4
+#define DISK_BYTES_WRITTEN  5
+#define DISK_ERRORS         6
+uint32_t disk_counter(uint32_t which);
+
 // Provided by application
 void init();
 void update();
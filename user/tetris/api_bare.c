@@ -34,6 +34,108 @@ uint32_t buttons()
     return syscall(2, 0, 0);
 }
 
+uint32_t display_mode(uint32_t width, uint32_t height, uint32_t bpp, uint32_t order)
+{
+    return syscall(12, width | (height << 16), bpp | (order << 8));
+}
+
+uint32_t display_size()
+{
+    return syscall(13, 0, 0);
+}
+
+uint32_t layer(uint32_t index, const layer_desc *desc)
+{
+    return syscall(14, index, (uint32_t)desc);
+}
+
+int32_t file_open(const char *path, uint32_t mode)
+{
+    return syscall(15, (uint32_t)path, mode);
+}
+
+int32_t file_close(int32_t fd)
+{
+    return syscall(16, fd, 0);
+}
+
+int32_t file_read(int32_t fd, void *buf, uint32_t len)
+{
+    struct { uint32_t buf, len; } io = { (uint32_t)buf, len };
+    return syscall(17, fd, (uint32_t)&io);
+}
+
+int32_t file_write(int32_t fd, const void *buf, uint32_t len)
+{
+    struct { uint32_t buf, len; } io = { (uint32_t)buf, len };
+    return syscall(22, fd, (uint32_t)&io);
+}
+
+int32_t file_sync(int32_t fd)
+{
+    return syscall(23, fd, 0);
+}
+
+int32_t file_seek(int32_t fd, uint32_t offs)
+{
+    return syscall(18, fd, offs);
+}
+
+int32_t file_stat(const char *path, file_info *info)
+{
+    return syscall(19, (uint32_t)path, (uint32_t)info);
+}
+
+int32_t dir_open(const char *path)
+{
+    return syscall(20, (uint32_t)path, 0);
+}
+
+int32_t dir_read(int32_t fd, file_info *info)
+{
+    return syscall(21, fd, (uint32_t)info);
+}
+
+uint32_t disk_counter(uint32_t which)
+{
+    return syscall(24, which, 0);
+}
+
+void *back_buffer()
+{
+    return (void *)syscall(5, 0, 0);
+}
+
+void damage(const damage_rect *rects, uint32_t count)
+{
+    syscall(6, (uint32_t)rects, count);
+}
+
+void swap_policy(uint32_t policy, uint32_t count)
+{
+    syscall(7, policy, count);
+}
+
+uint32_t frame_counter(uint32_t which)
+{
+    return syscall(8, which, 0);
+}
+
+void schedule(uint32_t max_catchup, uint32_t max_skip)
+{
+    syscall(9, max_catchup, max_skip);
+}
+
+uint32_t frame_time(uint32_t phase, uint32_t stat)
+{
+    return syscall(10, phase, stat);
+}
+
+void frame_time_overlay(uint32_t on)
+{
+    syscall(11, on, 0);
+}
+
 int main()
 {
     crt_init();
@@ -2,9 +2,11 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+#include <dirent.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "api.h"
@@ -30,6 +32,45 @@ static float vertices[6][4] = {
 };
 
 static uint8_t buf[TEX_W * TEX_H * 3];
+static uint32_t bpp = 24;
+static layer_desc layers[4];
+
+// Same as the kernel's compositor, without the damage tracking
+static void compose()
+{
+    uint32_t bypp = bpp / 8;
+    for (int i = 1; i < 4; i++) {
+        const layer_desc *l = &layers[i];
+        if (l->mode == 0) continue;
+        uint32_t a = l->alpha + (l->alpha >> 7);
+        uint8_t key[3] = { l->key & 0xff, (l->key >> 8) & 0xff, (l->key >> 16) & 0xff };
+        for (uint32_t y = l->y; y < l->y + l->h && y < TEX_H; y++)
+        for (uint32_t x = l->x; x < l->x + l->w && x < TEX_W; x++) {
+            uint8_t *d = buf + (y * TEX_W + x) * bypp;
+            const uint8_t *s = (l->mode == LAYER_FILL ? NULL :
+                (const uint8_t *)l->pixels + ((y - l->y) * l->w + (x - l->x)) * bypp);
+            if (l->mode == LAYER_OPAQUE) {
+                memcpy(d, s, bypp);
+            } else if (l->mode == LAYER_KEY) {
+                if (bypp == 2 ? *(const uint16_t *)s != (uint16_t)l->key :
+                    (s[0] != key[0] || s[1] != key[1] || s[2] != key[2]))
+                    memcpy(d, s, bypp);
+            } else if (bypp == 2) {
+                uint16_t dc = *(uint16_t *)d, sc = (s ? *(const uint16_t *)s : l->key);
+                int32_t c[3][2] = {
+                    { dc >> 11, sc >> 11 },
+                    { (dc >> 5) & 63, (sc >> 5) & 63 },
+                    { dc & 31, sc & 31 },
+                };
+                for (int k = 0; k < 3; k++) c[k][0] += ((c[k][1] - c[k][0]) * (int32_t)a) >> 8;
+                *(uint16_t *)d = (c[0][0] << 11) | (c[1][0] << 5) | c[2][0];
+            } else {
+                for (int k = 0; k < 3; k++)
+                    d[k] += (((int32_t)(s ? s[k] : key[k]) - d[k]) * (int32_t)a) >> 8;
+            }
+        }
+    }
+}
 
 static void glfw_err_callback(int error, const char *desc)
 {
@@ -195,10 +236,16 @@ int main()
 
         // TODO: Optionally skip draw() calls
         void *nbuf = draw();
-        memcpy(buf, nbuf, sizeof buf);
-
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, TEX_W, TEX_H,
-            0, GL_BGR, GL_UNSIGNED_BYTE, buf);
+        if (layers[0].mode != 0) nbuf = (void *)layers[0].pixels;
+        if (nbuf != NULL && nbuf != buf) memcpy(buf, nbuf, TEX_W * TEX_H * bpp / 8);
+        compose();
+
+        if (bpp == 16)
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, TEX_W, TEX_H,
+                0, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, buf);
+        else
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, TEX_W, TEX_H,
+                0, GL_BGR, GL_UNSIGNED_BYTE, buf);
         glDrawArrays(GL_TRIANGLES, 0, 6);
 
         glfwSwapBuffers(window);
@@ -213,6 +260,218 @@ void register_loop(update_func_t update, draw_func_t draw)
 {
 }
 
+void *back_buffer()
+{
+    return buf;
+}
+
+void damage(const damage_rect *rects, uint32_t count)
+{
+}
+
+void swap_policy(uint32_t policy, uint32_t count)
+{
+}
+
+uint32_t frame_counter(uint32_t which)
+{
+    return 0;
+}
+
+void schedule(uint32_t max_catchup, uint32_t max_skip)
+{
+}
+
+uint32_t frame_time(uint32_t phase, uint32_t stat)
+{
+    return 0;
+}
+
+void frame_time_overlay(uint32_t on)
+{
+}
+
+uint32_t display_mode(uint32_t width, uint32_t height, uint32_t _bpp, uint32_t order)
+{
+    // The window is created for the only size in use
+    if (width != TEX_W || height != TEX_H) return 0;
+    memset(layers, 0, sizeof layers);
+    if (_bpp == 16) {
+        bpp = 16;
+        return 1;
+    }
+    if (_bpp == 24 && order == PIXEL_ORDER_BGR) {
+        bpp = 24;
+        return 1;
+    }
+    return 0;
+}
+
+uint32_t layer(uint32_t index, const layer_desc *desc)
+{
+    if (index >= 4) return 0;
+    if (desc == NULL) {
+        layers[index].mode = 0;
+        return 1;
+    }
+    if (index == 0 && (desc->mode != LAYER_OPAQUE || desc->x != 0 || desc->y != 0 ||
+        desc->w != TEX_W || desc->h != TEX_H))
+        return 0;
+    layers[index] = *desc;
+    return 1;
+}
+
+// Files are looked up under this directory in place of the card's root
+#ifndef FILE_ROOT
+#define FILE_ROOT   "."
+#endif
+
+// FatFs result codes, as returned by the kernel
+#define FR_DISK_ERR             1
+#define FR_NO_FILE              4
+#define FR_INVALID_OBJECT       9
+#define FR_TOO_MANY_OPEN_FILES  18
+#define FR_INVALID_PARAMETER    19
+
+static struct {
+    FILE *f;
+    DIR *d;
+    char path[512];
+} files[8];
+
+static void host_path(char *buf, size_t size, const char *path)
+{
+    while (*path == '/') path++;
+    snprintf(buf, size, "%s/%s", FILE_ROOT, path);
+}
+
+static int32_t file_alloc()
+{
+    for (int32_t i = 0; i < 8; i++)
+        if (files[i].f == NULL && files[i].d == NULL) return i;
+    return -FR_TOO_MANY_OPEN_FILES;
+}
+
+static void fill_info(file_info *info, const char *path, const char *name)
+{
+    struct stat st;
+    memset(info, 0, sizeof *info);
+    if (stat(path, &st) == 0) {
+        info->dir = S_ISDIR(st.st_mode);
+        info->size = (info->dir ? 0 : (uint32_t)st.st_size);
+    }
+    snprintf(info->name, FILE_NAME_MAX, "%s", name);
+}
+
+int32_t file_open(const char *path, uint32_t mode)
+{
+    if ((mode & ~(FILE_READ | FILE_WRITE | FILE_CREATE | FILE_APPEND)) != 0 ||
+        (mode & (FILE_READ | FILE_WRITE)) == 0)
+        return -FR_INVALID_PARAMETER;
+    int32_t fd = file_alloc();
+    if (fd < 0) return fd;
+    char p[512];
+    host_path(p, sizeof p, path);
+    if (!(mode & FILE_WRITE)) {
+        files[fd].f = fopen(p, "rb");
+    } else if (mode & FILE_CREATE) {
+        files[fd].f = fopen(p, "w+b");
+    } else {
+        // Opened for update, created first if asked to
+        files[fd].f = fopen(p, "r+b");
+        if (files[fd].f == NULL && (mode & FILE_APPEND)) files[fd].f = fopen(p, "w+b");
+        if (files[fd].f != NULL && (mode & FILE_APPEND) == FILE_APPEND)
+            fseek(files[fd].f, 0, SEEK_END);
+    }
+    if (files[fd].f == NULL) return -FR_NO_FILE;
+    return fd;
+}
+
+int32_t file_close(int32_t fd)
+{
+    if (fd < 0 || fd >= 8) return -FR_INVALID_OBJECT;
+    if (files[fd].f != NULL) fclose(files[fd].f);
+    else if (files[fd].d != NULL) closedir(files[fd].d);
+    else return -FR_INVALID_OBJECT;
+    files[fd].f = NULL;
+    files[fd].d = NULL;
+    return 0;
+}
+
+int32_t file_read(int32_t fd, void *buf, uint32_t len)
+{
+    if (fd < 0 || fd >= 8 || files[fd].f == NULL) return -FR_INVALID_OBJECT;
+    fseek(files[fd].f, 0, SEEK_CUR);
+    size_t n = fread(buf, 1, len, files[fd].f);
+    return (ferror(files[fd].f) ? -FR_DISK_ERR : (int32_t)n);
+}
+
+int32_t file_write(int32_t fd, const void *buf, uint32_t len)
+{
+    if (fd < 0 || fd >= 8 || files[fd].f == NULL) return -FR_INVALID_OBJECT;
+    // Switching between reading and writing needs a seek in between
+    fseek(files[fd].f, 0, SEEK_CUR);
+    size_t n = fwrite(buf, 1, len, files[fd].f);
+    return (ferror(files[fd].f) ? -FR_DISK_ERR : (int32_t)n);
+}
+
+int32_t file_sync(int32_t fd)
+{
+    if (fd < 0 || fd >= 8 || files[fd].f == NULL) return -FR_INVALID_OBJECT;
+    return (fflush(files[fd].f) == 0 ? 0 : -FR_DISK_ERR);
+}
+
+int32_t file_seek(int32_t fd, uint32_t offs)
+{
+    if (fd < 0 || fd >= 8 || files[fd].f == NULL) return -FR_INVALID_OBJECT;
+    return (fseek(files[fd].f, offs, SEEK_SET) == 0 ? 0 : -FR_DISK_ERR);
+}
+
+int32_t file_stat(const char *path, file_info *info)
+{
+    char p[512];
+    host_path(p, sizeof p, path);
+    if (access(p, F_OK) != 0) return -FR_NO_FILE;
+    const char *name = strrchr(path, '/');
+    fill_info(info, p, (name ? name + 1 : path));
+    return 0;
+}
+
+int32_t dir_open(const char *path)
+{
+    int32_t fd = file_alloc();
+    if (fd < 0) return fd;
+    host_path(files[fd].path, sizeof files[fd].path, path);
+    if ((files[fd].d = opendir(files[fd].path)) == NULL) return -FR_NO_FILE;
+    return fd;
+}
+
+int32_t dir_read(int32_t fd, file_info *info)
+{
+    if (fd < 0 || fd >= 8 || files[fd].d == NULL) return -FR_INVALID_OBJECT;
+    struct dirent *e;
+    // FatFs leaves out the dot entries
+    do e = readdir(files[fd].d);
+    while (e != NULL && (!strcmp(e->d_name, ".") || !strcmp(e->d_name, "..")));
+    if (e == NULL) return 0;
+    char p[1024];
+    snprintf(p, sizeof p, "%s/%s", files[fd].path, e->d_name);
+    fill_info(info, p, e->d_name);
+    return 1;
+}
+
+uint32_t disk_counter(uint32_t which)
+{
+    return 0;
+}
+
+uint32_t display_size()
+{
+    int w, h;
+    glfwGetFramebufferSize(window, &w, &h);
+    return w | (h << 16);
+}
+
 uint32_t buttons()
 {
     if (buttons_updated) return last_buttons;
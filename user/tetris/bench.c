@@ -0,0 +1,149 @@
+// Host benchmark: the bitboard in tetris.c against the cell-by-cell
+// checks it replaced, on random boards
+// cc -O2 -std=c99 bench.c -o bench
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "tetris.c"
+
+#define BOARDS  1000
+#define ROUNDS  200
+
+// The previous implementation, on matrix alone
+static bool cell_fits(uint8_t type, uint8_t ori, int8_t row, int8_t col)
+{
+    for (uint8_t i = 0; i < 4; i++) {
+        uint8_t r = row + TETRO[type].mino[ori][i][0];
+        uint8_t c = col + TETRO[type].mino[ori][i][1];
+        if (r >= MATRIX_H || c >= MATRIX_W || matrix[r][c] != MINO_NONE)
+            return false;
+    }
+    return true;
+}
+
+static int8_t cell_ghost(uint8_t type, uint8_t ori, int8_t row, int8_t col)
+{
+    while (cell_fits(type, ori, row, col)) row--;
+    return row + 1;
+}
+
+static uint32_t cell_full_rows()
+{
+    uint32_t ret = 0;
+    for (uint8_t i = 0; i < MATRIX_H; i++) {
+        bool full = true;
+        for (uint8_t c = 0; c < MATRIX_W; c++)
+            if (matrix[i][c] == MINO_NONE) { full = false; break; }
+        if (full) ret |= (1 << i);
+    }
+    return ret;
+}
+
+static uint32_t bit_full_rows()
+{
+    uint32_t ret = 0;
+    for (uint8_t i = 0; i < MATRIX_H; i++)
+        if (matrix_bits[i] == MATRIX_ROW_FULL) ret |= (1 << i);
+    return ret;
+}
+
+// Rough stacks: full-ish at the bottom, thinning out upwards
+static void random_board(uint8_t board[MATRIX_H][MATRIX_W], uint16_t bits[MATRIX_H])
+{
+    uint32_t height = 4 + mrand() % 14;
+    for (uint8_t r = 0; r < MATRIX_H; r++) {
+        bits[r] = 0;
+        for (uint8_t c = 0; c < MATRIX_W; c++) {
+            bool set = (r < height && mrand() % 16 < (r % 4 == 0 ? 16u : 13u));
+            board[r][c] = (set ? mrand() % 7 : MINO_NONE);
+            if (set) bits[r] |= 1 << c;
+        }
+    }
+}
+
+static uint8_t boards[BOARDS][MATRIX_H][MATRIX_W];
+static uint16_t boards_bits[BOARDS][MATRIX_H];
+
+static double now()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static void load(uint32_t b)
+{
+    memcpy(matrix, boards[b], sizeof matrix);
+    memcpy(matrix_bits, boards_bits[b], sizeof boards_bits[b]);
+}
+
+// Every piece in every orientation and column, from above the skyline
+// down to where it lands, as a placement search would
+static uint32_t sink;
+
+static void run_cells()
+{
+    for (uint32_t b = 0; b < BOARDS; b++) {
+        load(b);
+        for (uint8_t t = 0; t < 7; t++)
+        for (uint8_t o = 0; o < 4; o++)
+        for (int8_t c = -3; c < MATRIX_W; c++)
+            if (cell_fits(t, o, MATRIX_HV, c)) sink += cell_ghost(t, o, MATRIX_HV, c);
+        sink += cell_full_rows();
+    }
+}
+
+static void run_bits()
+{
+    for (uint32_t b = 0; b < BOARDS; b++) {
+        load(b);
+        for (uint8_t t = 0; t < 7; t++)
+        for (uint8_t o = 0; o < 4; o++)
+        for (int8_t c = -3; c < MATRIX_W; c++)
+            if (tetris_fits(t, o, MATRIX_HV, c)) sink += tetris_landing(t, o, MATRIX_HV, c);
+        sink += bit_full_rows();
+    }
+}
+
+int main()
+{
+    tetro_init();
+    for (uint32_t b = 0; b < BOARDS; b++) random_board(boards[b], boards_bits[b]);
+
+    // Agree everywhere first
+    for (uint32_t b = 0; b < BOARDS; b++) {
+        load(b);
+        if (cell_full_rows() != bit_full_rows()) {
+            fprintf(stderr, "Full rows differ on board %u\n", b);
+            return 1;
+        }
+        for (uint8_t t = 0; t < 7; t++)
+        for (uint8_t o = 0; o < 4; o++)
+        for (int8_t r = -4; r < MATRIX_H; r++)
+        for (int8_t c = -4; c < MATRIX_W + 2; c++) {
+            bool f = cell_fits(t, o, r, c);
+            if (f != tetris_fits(t, o, r, c) ||
+                    (f && cell_ghost(t, o, r, c) != tetris_landing(t, o, r, c))) {
+                fprintf(stderr, "Mismatch on board %u: type %u, orientation %u at (%d, %d)\n",
+                    b, t, o, r, c);
+                return 1;
+            }
+        }
+    }
+
+    double t0 = now();
+    for (uint32_t i = 0; i < ROUNDS; i++) run_cells();
+    double t1 = now();
+    for (uint32_t i = 0; i < ROUNDS; i++) run_bits();
+    double t2 = now();
+
+    double n = (double)BOARDS * ROUNDS;
+    printf("Cells:    %8.2f us per board\n", (t1 - t0) / n * 1e6);
+    printf("Bitboard: %8.2f us per board\n", (t2 - t1) / n * 1e6);
+    printf("Speedup:  %8.2fx\n", (t1 - t0) / (t2 - t1));
+    return (sink == 0xffffffff);
+}
@@ -0,0 +1,7 @@
+#!/bin/sh
+# Bakes background01.png into bg.h; needs ffmpeg and a host compiler
+set -e
+cc -O2 -std=c99 ../asset/bake.c -o ../asset/bake
+ffmpeg -v error -i background01.png -f rawvideo -pix_fmt bgr24 - |
+    ../asset/bake 256 256 400 400 0 80 400 240 24 > bg.h.tmp
+mv bg.h.tmp bg.h
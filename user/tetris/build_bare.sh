@@ -1,2 +1,3 @@
 #!/bin/sh
-arm-none-eabi-gcc -mfpu=vfp -mfloat-abi=hard -march=armv6k -mtune=arm1176jzf-s -nostartfiles -Wl,-T,link.ld -std=c99 -O2 api_bare.c tetris.c main.c -lm
+./bg.sh || exit 1
+arm-none-eabi-gcc -mfpu=vfp -mfloat-abi=hard -march=armv6k -mtune=arm1176jzf-s -nostartfiles -Wl,-T,link.ld -std=c99 -O2 api_bare.c ../asset/asset.c ../fixmath/fixmath.c ../gfx/gfx.c ../particle/particle.c tetris.c main.c
@@ -1,2 +1,3 @@
 #!/bin/sh
-gcc api_glfw.c tetris.c main.c -framework OpenGL -lGLFW -lglew -O2 -std=c99
+./bg.sh || exit 1
+gcc api_glfw.c ../asset/asset.c ../fixmath/fixmath.c ../gfx/gfx.c ../particle/particle.c tetris.c main.c -framework OpenGL -lGLFW -lglew -O2 -std=c99
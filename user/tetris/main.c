@@ -1,16 +1,14 @@
 #include "api.h"
 #include "tetris.h"
+#include "../asset/asset.h"
+#include "../fixmath/fixmath.h"
+#include "../font/font.h"
+#include "../gfx/gfx.h"
+#include "../particle/particle.h"
+#include "../pix/pix.h"
 
-#include <math.h>
 #include <string.h>
 
-#ifndef M_PI
-#define M_PI  3.1415926535897932384626433832795
-#endif
-#ifndef M_SQRT1_2
-#define M_SQRT1_2   0.7071067811865476
-#endif
-
 #define MINO_W      11
 
 #define MATRIX_X1   ((400 - MATRIX_W * MINO_W) / 2)
@@ -18,11 +16,14 @@
 #define MATRIX_X2   (MATRIX_X1 + MATRIX_W * MINO_W)
 #define MATRIX_Y2   (MATRIX_Y1 - MATRIX_HV * MINO_W)
 
-#define CHAR_W  7
-#define CHAR_H  14
-static uint8_t font_data[CHAR_W * CHAR_H * 16 * 6];
+#define CHAR_W  FONT_W
+#define CHAR_H  FONT_H
 
 static uint8_t buf[240][400][3];
+static gfx_surface scr;
+
+// buf holds [B, G, R]
+#define RGB(r, g, b)    (((r) << 16) | ((g) << 8) | (b))
 
 #define SCR_MENU    0
 #define SCR_GAME    1
@@ -46,59 +47,16 @@ static void game_draw();
 static void overlay_init();
 static void overlay_draw();
 
-static inline void pix(uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b)
-{
-    buf[y][x][2] = r;
-    buf[y][x][1] = g;
-    buf[y][x][0] = b;
-}
-
-static inline void pix_semi(uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b)
-{
-    buf[y][x][2] += ((r - buf[y][x][2]) >> 2) * 3;
-    buf[y][x][1] += ((g - buf[y][x][1]) >> 2) * 3;
-    buf[y][x][0] += ((b - buf[y][x][0]) >> 2) * 3;
-}
-
-static inline void pix_alpha(uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
-{
-    buf[y][x][2] += ((uint16_t)(r - buf[y][x][2]) * a) >> 8;
-    buf[y][x][1] += ((uint16_t)(g - buf[y][x][1]) * a) >> 8;
-    buf[y][x][0] += ((uint16_t)(b - buf[y][x][0]) * a) >> 8;
-}
-
-static inline void lineh(
-    uint16_t x1, uint16_t x2, uint16_t y, uint8_t r, uint8_t g, uint8_t b)
-{
-    for (; x1 <= x2; x1++) pix(x1, y, r, g, b);
-}
-
-static inline void linev(
-    uint16_t x, uint16_t y1, uint16_t y2, uint8_t r, uint8_t g, uint8_t b)
+// White with a grey shadow
+static inline void text_str_on(gfx_surface *s, uint16_t x, uint16_t y, const char *str)
 {
-    for (; y1 <= y2; y1++) pix(x, y1, r, g, b);
-}
-
-static inline void text_char(uint16_t x, uint16_t y, signed char ch)
-{
-    if (ch < 32) return;
-    uint8_t row = (ch - 32) / 16;
-    uint8_t col = (ch - 32) % 16;
-    uint16_t ptr = row * CHAR_W * 16 * CHAR_H + col * CHAR_W;
-    for (uint8_t j = 0; j < CHAR_H; j++)
-    for (uint8_t i = 0; i < CHAR_W; i++)
-        if (font_data[ptr + (j * CHAR_W * 16 + i)]) {
-            pix(x + i, y + j, 255, 255, 255);
-            pix(x + i + 1, y + j + 1, 108, 108, 108);
-        }
+    gfx_text(s, x + 1, y + 1, str, RGB(108, 108, 108));
+    gfx_text(s, x, y, str, RGB(255, 255, 255));
 }
 
 static inline void text_str(uint16_t x, uint16_t y, const char *str)
 {
-    while (*str != 0) {
-        text_char(x, y, *(str++));
-        x += CHAR_W;
-    }
+    text_str_on(&scr, x, y, str);
 }
 
 static inline void text_xcen(uint16_t x, uint16_t y, const char *str)
@@ -108,24 +66,22 @@ static inline void text_xcen(uint16_t x, uint16_t y, const char *str)
 }
 
 
+// Baked at the screen size by bg.sh: the 256x256 image scaled to
+// 400x400 and cropped from row 80
 static const uint8_t bg[] = {
-    // ffmpeg -f rawvideo -pix_fmt rgb24 - -i background01.png | xxd -i > bg.h
     #include "bg.h"
 };
+#if !defined(ASSET_W) || ASSET_W != 400 || ASSET_H != 240 || ASSET_BPP != 24
+#error "bg.h is not a baked 400x240, 24 bpp asset; run bg.sh"
+#endif
 
 
-#define PARTICLES_MAX   4096
 #define PARTICLE_LIFE   60
 #define PARTICLE_RADIUS 8
 
-static uint16_t particle_count = 0;
-static struct particle {
-    uint16_t x, y;
-    uint8_t r, g, b;
-    float vx, vy;
-    uint32_t t;
-    uint16_t life;
-} particles[PARTICLES_MAX];
+static particles ps;
+// exp(-5 / life) and 1 - that, by life
+static q16 particle_damp[PARTICLE_LIFE], particle_reach[PARTICLE_LIFE];
 
 // XXX: Duplication?
 static inline uint32_t mrand()
@@ -134,34 +90,109 @@ static inline uint32_t mrand()
     return (seed = ((seed * 1103515245) + 12345) & 0x7fffffff);
 }
 
-static inline void add_particle(uint32_t T, uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b)
+// Flies PARTICLE_RADIUS pixels or so from (x, y), slowing down as
+// 1 - exp(-5 * age / life), and fades out
+static inline void add_particle(uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b)
+{
+    fx_angle a = mrand() >> 15;
+    uint16_t life = mrand() % PARTICLE_LIFE;
+    q16 l = FX(0.8) + fx_mul(mrand() >> 15, FX(0.4));
+    if (life == 0) return;
+    fx_vec v = fx_vpolar(fx_mul(PARTICLE_RADIUS * l, particle_reach[life]), a);
+    particle_add(&ps, x << 16, y << 16, v.x, v.y,
+        particle_damp[life], life, RGB(r, g, b));
+}
+
+static void particle_tables_init()
+{
+    for (uint16_t life = 1; life < PARTICLE_LIFE; life++) {
+        particle_damp[life] = fx_exp(-5 * FX_ONE / life);
+        particle_reach[life] = FX_ONE - particle_damp[life];
+    }
+}
+
+
+////// FRAME //////
+
+// buf holds a base image (bg_pix or field_pix) with a few things drawn
+// over it. Rather than copying the whole base every frame, only what the
+// last frame drew over it and what has changed in the base since are
+// copied back; those, and what this frame draws, go to damage().
+// Opaque text drawn every frame in the same place needs no marking.
+#define DIRTY_MAX   16      // As many as damage() takes
+
+typedef struct dirty_list {
+    uint8_t count;
+    damage_rect r[DIRTY_MAX];
+} dirty_list;
+
+static uint8_t (*frame_base)[400][3];   // NULL: copy all of it
+static dirty_list base_dirty;   // Changed in the base
+static dirty_list drawn;        // Drawn over the base by the last frame
+static dirty_list report;
+static bool frame_full;
+
+// Clipped to the screen; merged into the last one when out of slots
+static void dirty_add(dirty_list *l, int x, int y, int w, int h)
 {
-    if (particle_count >= PARTICLES_MAX) return;
-    float a = (float)mrand() / 0x80000000u * M_PI * 2;
-    uint16_t t = mrand() % PARTICLE_LIFE;
-    float l = ((float)mrand() / 0x80000000u * 0.4f + 0.8f);
-    particles[particle_count++] = (struct particle) {
-        x, y, r, g, b, PARTICLE_RADIUS * l * cosf(a), PARTICLE_RADIUS * l * sinf(a), T, t
-    };
+    int x2 = x + w, y2 = y + h;
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x2 > 400) x2 = 400;
+    if (y2 > 240) y2 = 240;
+    if (x >= x2 || y >= y2) return;
+
+    if (l->count == DIRTY_MAX) {
+        damage_rect *r = &l->r[--l->count];
+        if (x > r->x) x = r->x;
+        if (y > r->y) y = r->y;
+        if (x2 < r->x + r->w) x2 = r->x + r->w;
+        if (y2 < r->y + r->h) y2 = r->y + r->h;
+    }
+    l->r[l->count++] = (damage_rect){ x, y, x2 - x, y2 - y };
 }
 
-static inline void update_and_draw_particles()
+static void frame_begin(uint8_t (*base)[400][3])
 {
-    for (uint16_t i = 0; i < particle_count; i++) {
-        if (T >= particles[i].t + particles[i].life) {
-            // To be removed
-            particles[i] = particles[--particle_count];
-            i--;
-        } else {
-            float r0 = (float)(T - particles[i].t) / particles[i].life;
-            float r = 1 - expf(-r0 * 5);
-            pix_alpha(
-                (uint16_t)(particles[i].x + particles[i].vx * r),
-                (uint16_t)(particles[i].y + particles[i].vy * r),
-                particles[i].r, particles[i].g, particles[i].b,
-                (uint8_t)(255 * (1 - r0) + 0.5f));
+    report.count = 0;
+    frame_full = (base != frame_base);
+    if (frame_full) {
+        memcpy(buf, base, sizeof buf);
+        frame_base = base;
+    } else {
+        for (uint8_t i = 0; i < drawn.count; i++)
+            dirty_add(&report, drawn.r[i].x, drawn.r[i].y, drawn.r[i].w, drawn.r[i].h);
+        for (uint8_t i = 0; i < base_dirty.count; i++)
+            dirty_add(&report, base_dirty.r[i].x, base_dirty.r[i].y, base_dirty.r[i].w, base_dirty.r[i].h);
+        for (uint8_t i = 0; i < report.count; i++) {
+            const damage_rect *r = &report.r[i];
+            for (uint16_t y = r->y; y < r->y + r->h; y++)
+                memcpy(buf[y][r->x], base[y][r->x], r->w * 3);
         }
     }
+    base_dirty.count = 0;
+    drawn.count = 0;
+}
+
+static inline void frame_mark(int x, int y, int w, int h)
+{
+    dirty_add(&drawn, x, y, w, h);
+}
+
+static inline void frame_mark_particles()
+{
+    int x1, y1, x2, y2;
+    if (particles_bounds(&ps, &x1, &y1, &x2, &y2))
+        frame_mark(x1, y1, x2 - x1, y2 - y1);
+}
+
+// Without a report, the whole frame is presented
+static void frame_end()
+{
+    if (frame_full) return;
+    for (uint8_t i = 0; i < drawn.count; i++)
+        dirty_add(&report, drawn.r[i].x, drawn.r[i].y, drawn.r[i].w, drawn.r[i].h);
+    damage(report.r, report.count);
 }
 
 
@@ -175,6 +206,7 @@ static uint32_t menu_sel_time = 0;
 static void menu_update()
 {
     T++;
+    particles_update(&ps, T);
 
     uint8_t m0 = menu_sel;
 
@@ -189,7 +221,7 @@ static void menu_update()
         uint16_t x = mrand() % 128 + 64;
         uint16_t y = mrand() % 128 + 64;
         for (uint8_t i = 0; i < 64; i++)
-            add_particle(T, x, y,
+            add_particle(x, y,
                 mrand() % 128 + 128, mrand() % 128 + 128, mrand() % 128 + 128);
     }
 
@@ -206,17 +238,20 @@ static void menu_draw()
     text_xcen(200, 120 + 24, "Sprint");
     text_xcen(200, 120 + 48, "Ultra");
 
-    int16_t x = sinf((float)T * 0.06f) * 1.9;
+    int16_t x = fx_mul(fx_sin(T * 626), FX(1.9)) / FX_ONE;     // 0.06 rad a tick
     uint16_t y = menu_sel * 24;
     if (menu_sel_time + MENU_TRANSITION_DUR >= T) {
-        float rate = expf((float)(T - menu_sel_time) / MENU_TRANSITION_DUR * -4);
-        y -= (menu_sel - last_menu_sel) * rate * 24;
+        q16 rate = fx_exp((int32_t)(T - menu_sel_time) * -4 * FX_ONE / MENU_TRANSITION_DUR);
+        y -= fx_mul((menu_sel - last_menu_sel) * 24, rate);
     }
 
-    text_char(144 - CHAR_W / 2 + x, 123 + y, '~');
-    text_char(256 - CHAR_W / 2 - x, 123 + y, '~');
+    text_str(144 - CHAR_W / 2 + x, 123 + y, "~");
+    text_str(256 - CHAR_W / 2 - x, 123 + y, "~");
+    frame_mark(144 - CHAR_W / 2 + x, 123 + y, CHAR_W + 1, CHAR_H + 1);
+    frame_mark(256 - CHAR_W / 2 - x, 123 + y, CHAR_W + 1, CHAR_H + 1);
 
-    update_and_draw_particles();
+    particles_draw(&ps, &scr);
+    frame_mark_particles();
 }
 
 
@@ -226,6 +261,9 @@ static int8_t last_hor = 0;
 static uint32_t hor_hold = 0;
 static uint32_t drop_hold = 0;
 
+// The playfield layer needs redrawing
+static bool field_dirty;
+
 static const uint8_t MINO_COLOURS[7][3] = {
     {254, 203, 0},
     {0, 159, 218},
@@ -243,11 +281,13 @@ static void game_init()
 
     tetro_init();
     tetris_spawn();
+    field_dirty = true;
 }
 
 static void game_update()
 {
     T++;
+    particles_update(&ps, T);
 
     int32_t hor = 0;
     if (b0 & BUTTON_LEFT) hor -= 1;
@@ -272,11 +312,12 @@ static void game_update()
         tetris_rotate(+1);
     if ((b0 & BUTTON_CRO) && !(b1 & BUTTON_CRO)) tetris_rotate(-1);
     if ((b0 & BUTTON_SQR) && !(b1 & BUTTON_SQR)) tetris_harddrop();
-    if ((b0 & BUTTON_TRI) && !(b1 & BUTTON_TRI)) tetris_hold();
+    if ((b0 & BUTTON_TRI) && !(b1 & BUTTON_TRI) && tetris_hold()) field_dirty = true;
 
     uint32_t action = tetris_tick();
     if (action & TETRIS_LOCKDOWN) {
         tetris_spawn();
+        field_dirty = true;
         if (action ^ TETRIS_LOCKDOWN) {
             for (uint8_t i = 0, k = 0; i < MATRIX_H; i++) if (action & (1 << i)) {
                 for (uint8_t c = 0; c < MATRIX_W; c++) {
@@ -289,7 +330,7 @@ static void game_update()
                     uint8_t b = MINO_COLOURS[t][2] + ((255 - MINO_COLOURS[t][2]) >> 1);
                     for (uint8_t x = 0; x < MINO_W; x += 4)
                     for (uint8_t y = 0; y < MINO_W; y += 4)
-                        add_particle(T, x0 + x, y0 + y, r, g, b);
+                        add_particle(x0 + x, y0 + y, r, g, b);
                 }
                 k++;
             }
@@ -310,147 +351,211 @@ static void game_update()
     }
 }
 
-// Top-left corner
-static inline void draw_mino(int8_t row, int8_t col, uint8_t t)
+// Minos of each type in the top row, ghosts in the bottom row
+static uint8_t mino_pix[MINO_W * 2][MINO_W * 7][3];
+static gfx_surface mino_surface;
+static const gfx_atlas minos = { &mino_surface, MINO_W, MINO_W };
+
+static void minos_init()
 {
-    if (row >= MATRIX_HV) return;
-    uint16_t x = MATRIX_X1 + col * MINO_W;
-    uint16_t y = MATRIX_Y1 - (row + 1) * MINO_W;
-    for (int i = 0; i < MINO_W; i++)
-    for (int j = 0; j < MINO_W; j++) {
+    gfx_init(&mino_surface, mino_pix, MINO_W * 7, MINO_W * 2, MINO_W * 7 * 3, 24);
+    for (int t = 0; t < 7; t++) {
         uint8_t r = MINO_COLOURS[t][0];
         uint8_t g = MINO_COLOURS[t][1];
         uint8_t b = MINO_COLOURS[t][2];
-        if (i == MINO_W - 1 || j == MINO_W - 1) {
-            r = (r >> 2) * 3;
-            g = (g >> 2) * 3;
-            b = (b >> 2) * 3;
-        } else if (i == 0 || j == 0) {
-            r = 255 - ((255 - r) >> 2) * 3;
-            g = 255 - ((255 - g) >> 2) * 3;
-            b = 255 - ((255 - b) >> 2) * 3;
-        }
-        pix(x + i, y + j, r, g, b);
+        uint32_t light = RGB(
+            255 - ((255 - r) >> 2) * 3,
+            255 - ((255 - g) >> 2) * 3,
+            255 - ((255 - b) >> 2) * 3);
+        uint32_t dark = RGB((r >> 2) * 3, (g >> 2) * 3, (b >> 2) * 3);
+        int x = t * MINO_W;
+        gfx_rect(&mino_surface, x, 0, MINO_W, MINO_W, RGB(r, g, b));
+        gfx_rect(&mino_surface, x, 0, MINO_W - 1, 1, light);
+        gfx_rect(&mino_surface, x, 0, 1, MINO_W - 1, light);
+        gfx_rect(&mino_surface, x + MINO_W - 1, 0, 1, MINO_W, dark);
+        gfx_rect(&mino_surface, x, MINO_W - 1, MINO_W, 1, dark);
+        gfx_rect(&mino_surface, x, MINO_W, MINO_W, MINO_W, RGB(r / 2, g / 2, b / 2));
     }
 }
 
+// Top-left corner
+static inline void draw_mino(gfx_surface *s, int8_t row, int8_t col, uint8_t t)
+{
+    if (row >= MATRIX_HV) return;
+    gfx_blit_cell(s,
+        MATRIX_X1 + col * MINO_W, MATRIX_Y1 - (row + 1) * MINO_W,
+        &minos, t, GFX_COPY, 0);
+}
+
+// Three quarters of the way towards half the colour
 static inline void draw_mino_ghost(uint8_t row, uint8_t col, uint8_t t)
 {
     if (row >= MATRIX_HV) return;
-    uint16_t x = MATRIX_X1 + col * MINO_W;
-    uint16_t y = MATRIX_Y1 - (row + 1) * MINO_W;
-    for (int i = 0; i < MINO_W; i++)
-    for (int j = 0; j < MINO_W; j++)
-        pix_semi(x + i, y + j,
-            MINO_COLOURS[t][0] / 2, MINO_COLOURS[t][1] / 2, MINO_COLOURS[t][2] / 2);
+    gfx_blit_cell(&scr,
+        MATRIX_X1 + col * MINO_W, MATRIX_Y1 - (row + 1) * MINO_W,
+        &minos, 7 + t, GFX_ALPHA, 192);
 }
 
-static inline void draw_matrix()
+// Cells of the dropping piece placed with its origin at (row, col)
+static void mark_piece(int8_t row, int8_t col)
 {
+    int r1 = MATRIX_HV, r2 = -1, c1 = MATRIX_W, c2 = -1;
+    for (int i = 0; i < 4; i++) {
+        int r = row + TETRO[drop_type].mino[drop_ori][i][0];
+        int c = col + TETRO[drop_type].mino[drop_ori][i][1];
+        if (r1 > r) r1 = r;
+        if (r2 < r) r2 = r;
+        if (c1 > c) c1 = c;
+        if (c2 < c) c2 = c;
+    }
+    frame_mark(MATRIX_X1 + c1 * MINO_W, MATRIX_Y1 - (r2 + 1) * MINO_W,
+        (c2 - c1 + 1) * MINO_W, (r2 - r1 + 1) * MINO_W);
+}
+
+// Everything on the game screen but the falling piece, its ghost and the
+// particles: the background, grid, locked minos, hold, preview and HUD.
+// Redrawn on lock down and hold; the counters are redrawn on their own
+// when they change. It is the base of game frames.
+static uint8_t field_pix[240][400][3];
+static gfx_surface field;
+static uint32_t hud_clear, hud_stat;    // As drawn
+
+static uint8_t bg_pix[240][400][3];
+
+#define HUD_X   104
+#define HUD_W   (3 * CHAR_W + 1)
+#define HUD_H   (CHAR_H + 1)
+
+static void hud_number(uint16_t y, uint32_t n, bool blank_zeros)
+{
+    for (uint16_t r = y; r < y + HUD_H; r++)
+        memcpy(field_pix[r][HUD_X], bg_pix[r][HUD_X], HUD_W * 3);
+    char s[4] = { 0 };
+    s[0] = '0' + n / 100;
+    s[1] = '0' + n / 10 % 10;
+    s[2] = '0' + n % 10;
+    if (blank_zeros && s[0] == '0') {
+        s[0] = ' ';
+        if (s[1] == '0') s[1] = ' ';
+    }
+    text_str_on(&field, HUD_X, y, s);
+    dirty_add(&base_dirty, HUD_X, y, HUD_W, HUD_H);
+}
+
+// Level in Marathon, seconds otherwise
+static inline uint32_t hud_stat_value()
+{
+    if (mode == MODE_MARATHON) return level;
+    return (mode == MODE_SPRINT ? T / 60 : ULTRA_DURATION - (T / 60));
+}
+
+static void field_draw()
+{
+    memcpy(field_pix, bg_pix, sizeof field_pix);
+    frame_base = NULL;
+
     for (int i = 0; i <= MATRIX_HV; i++)
-        lineh(MATRIX_X1, MATRIX_X2, MATRIX_Y1 - i * MINO_W, 96, 96, 96);
+        gfx_span(&field, MATRIX_X1, MATRIX_Y1 - i * MINO_W, MATRIX_X2 - MATRIX_X1 + 1, RGB(96, 96, 96));
     for (int j = 0; j <= MATRIX_W; j++)
-        linev(MATRIX_X1 + j * MINO_W, MATRIX_Y2, MATRIX_Y1, 96, 96, 96);
+        gfx_rect(&field, MATRIX_X1 + j * MINO_W, MATRIX_Y2, 1, MATRIX_Y1 - MATRIX_Y2 + 1, RGB(96, 96, 96));
 
     for (int i = 0; i < MATRIX_HV; i++)
     for (int j = 0; j < MATRIX_W; j++) {
         if (matrix[i][j] != MINO_NONE)
-            draw_mino(i, j, matrix[i][j]);
+            draw_mino(&field, i, j, matrix[i][j]);
     }
 
-    // Ghost
-    uint8_t ghost_row = tetris_ghost();
-    for (int i = 0; i < 4; i++)
-        draw_mino_ghost(
-            ghost_row + TETRO[drop_type].mino[drop_ori][i][0],
-            drop_pos[1] + TETRO[drop_type].mino[drop_ori][i][1],
-            drop_type);
-    // Dropping
-    for (int i = 0; i < 4; i++)
-        draw_mino(
-            drop_pos[0] + TETRO[drop_type].mino[drop_ori][i][0],
-            drop_pos[1] + TETRO[drop_type].mino[drop_ori][i][1],
-            drop_type);
-
     // Hold
-    text_str(82, 10, "Hold");
+    text_str_on(&field, 82, 10, "Hold");
     if (hold_type != MINO_NONE)
         for (int i = 0; i < 4; i++)
-            draw_mino(
+            draw_mino(&field,
                 MATRIX_HV - 2 - TETRO[hold_type].bbsize + TETRO[hold_type].mino[0][i][0],
                 -5 + TETRO[hold_type].mino[0][i][1],
                 hold_type);
 
     // Preview
-    text_str(269, 10, "Next");
+    text_str_on(&field, 269, 10, "Next");
     for (int i = 0; i < 4; i++)     // Preview index
     for (int j = 0; j < 4; j++) {   // Mino index
         uint8_t t = drop_next[(drop_pointer + i) % 14];
-        draw_mino(
+        draw_mino(&field,
             MATRIX_HV - 2 - i * 3 - TETRO[t].bbsize + TETRO[t].mino[0][j][0],
             MATRIX_W + 2 + TETRO[t].mino[0][j][1],
             t);
     }
 
-    update_and_draw_particles();
-
-    char s[4] = { 0 };
-
-    text_str(82, 120, "Clear");
-    s[0] = '0' + clear_count / 100;
-    s[1] = '0' + clear_count / 10 % 10;
-    s[2] = '0' + clear_count % 10;
-    text_str(104, 136, s);
+    text_str_on(&field, 82, 120, "Clear");
+    text_str_on(&field, 82, 172, (mode == MODE_MARATHON ? "Level" : "Time"));
+    hud_number(136, hud_clear = clear_count, false);
+    hud_number(188, hud_stat = hud_stat_value(), mode == MODE_MARATHON);
+}
 
-    if (mode == MODE_MARATHON) {
-        text_str(82, 172, "Level");
-        s[0] = '0' + level / 100;
-        s[1] = '0' + level / 10 % 10;
-        s[2] = '0' + level % 10;
-        if (s[0] == '0') {
-            s[0] = ' ';
-            if (s[1] == '0') s[1] = ' ';
-        }
-        text_str(104, 188, s);
-    } else {
-        text_str(82, 172, "Time");
-        uint32_t time = (mode == MODE_SPRINT ? T / 60 : ULTRA_DURATION - (T / 60));
-        s[0] = '0' + time / 100;
-        s[1] = '0' + time / 10 % 10;
-        s[2] = '0' + time % 10;
-        text_str(104, 188, s);
+static void field_update()
+{
+    if (field_dirty) {
+        field_draw();
+        field_dirty = false;
+        return;
     }
+    if (hud_clear != clear_count)
+        hud_number(136, hud_clear = clear_count, false);
+    uint32_t stat = hud_stat_value();
+    if (hud_stat != stat)
+        hud_number(188, hud_stat = stat, mode == MODE_MARATHON);
 }
 
 static void game_draw()
 {
-    draw_matrix();
+    field_update();
+    frame_begin(field_pix);
+
+    // Ghost
+    uint8_t ghost_row = tetris_ghost();
+    for (int i = 0; i < 4; i++)
+        draw_mino_ghost(
+            ghost_row + TETRO[drop_type].mino[drop_ori][i][0],
+            drop_pos[1] + TETRO[drop_type].mino[drop_ori][i][1],
+            drop_type);
+    mark_piece(ghost_row, drop_pos[1]);
+    // Dropping
+    for (int i = 0; i < 4; i++)
+        draw_mino(&scr,
+            drop_pos[0] + TETRO[drop_type].mino[drop_ori][i][0],
+            drop_pos[1] + TETRO[drop_type].mino[drop_ori][i][1],
+            drop_type);
+    mark_piece(drop_pos[0], drop_pos[1]);
+
+    particles_draw(&ps, &scr);
+    frame_mark_particles();
 }
 
 
 ////// OVERLAY //////
 
+static bool overlay_shown;
+
 void overlay_update()
 {
     if ((b0 & BUTTON_CRO) && !(b1 & BUTTON_CRO)) {
         // Restart
+        overlay_shown = false;
         screen = SCR_GAME;
         game_init();
     } else if ((b0 & BUTTON_CIR) && !(b1 & BUTTON_CIR)) {
         // Back
+        overlay_shown = false;
         last_menu_sel = menu_sel;
         menu_sel_time = T = 0;
         screen = SCR_MENU;
-        particle_count = 0; // Clear particles
+        particles_init(&ps, T);
     }
 }
 
 void overlay_draw()
 {
-    uint8_t *_buf = &buf[0][0][0];
-    for (size_t i = 0; i < sizeof buf; i++) _buf[i] = ((uint16_t)_buf[i] * 3) >> 3;
-    //uint8_t *start = &buf[64][0][0], *end = &buf[112][0][0];
-    //for (; start < end; start++) *start = ((uint16_t)*start * 3) >> 3;
+    // x * 3 / 8
+    pix_scale(&buf[0][0][0], sizeof buf, 96);
 
     const char *msg = (screen == SCR_WIN ?
         (mode == MODE_SPRINT ? "Supercalifragilisticexpialidocious" : "It's been great work!") :
@@ -458,6 +563,9 @@ void overlay_draw()
     text_xcen(200, 88, msg);
     text_str(155, 120, "[X] - Restart");
     text_str(155, 136, "[O] - Back");
+    // Darkened all over: the next frame starts from a fresh copy
+    frame_base = NULL;
+    overlay_shown = true;
 }
 
 
@@ -465,15 +573,20 @@ void overlay_draw()
 
 void bg_draw()
 {
-    for (uint16_t y = 0; y < 240; y++)
-    for (uint16_t x = 0; x < 400; x++)
-        memcpy(buf[y][x], bg + ((x * 256 / 400) + ((y + 80) * 256 / 400) * 256) * 3, 3);
+    frame_begin(bg_pix);
 }
 
 void init()
 {
     b0 = b1 = 0;
     screen = SCR_MENU;
+    display_mode(400, 240, 24, PIXEL_ORDER_BGR);
+    gfx_init(&scr, buf, 400, 240, 400 * 3, 24);
+    gfx_init(&field, field_pix, 400, 240, 400 * 3, 24);
+    minos_init();
+    particles_init(&ps, 0);
+    particle_tables_init();
+    asset_decode(bg, sizeof bg, bg_pix, 400 * 3);
 }
 
 void update()
@@ -490,216 +603,26 @@ void update()
 
 void *draw()
 {
-    bg_draw();
     switch (screen) {
-        case SCR_MENU: menu_draw(); break;
-        case SCR_GAME: game_draw(); break;
+        case SCR_MENU:
+            bg_draw();
+            menu_draw();
+            frame_end();
+            break;
+        case SCR_GAME:
+            game_draw();
+            frame_end();
+            break;
         case SCR_WIN: case SCR_LOSE:
+            // Still until a button is pressed
+            if (overlay_shown) {
+                report.count = 0;
+                damage(report.r, 0);
+                break;
+            }
             game_draw();
             overlay_draw();
         default: break;
     }
     return (void *)buf;
 }
-
-// print('\n'.join(map(lambda x: ''.join(map(chr, range(32 + 16 * x, 48 + 16 * x))), range(6))))
-// ffmpeg -f rawvideo -pix_fmt gray - -i tamzen14.png | hexdump -ve '1/1 "%.2x"' | fold -w96 | sed -e 's/00/0,/g' | sed -e 's/ff/1,/g'
-
-static uint8_t font_data[CHAR_W * CHAR_H * 16 * 6] = {
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,
-    1,0,1,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,1,0,0,0,
-    0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,
-    0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,1,0,1,0,0,0,0,1,0,1,0,0,0,0,0,1,0,0,0,0,1,0,0,0,0,0,0,1,0,1,0,0,
-    0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,1,0,1,0,0,0,0,1,0,1,0,0,0,0,1,1,
-    1,1,0,1,0,1,0,0,1,0,0,1,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,
-    1,0,1,0,0,0,1,1,1,1,1,0,0,1,0,0,0,0,0,1,0,1,0,1,0,0,0,1,0,1,0,0,0,0,0,0,1,0,0,0,0,0,1,0,0,0,0,0,
-    0,0,0,1,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,
-    0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,1,0,1,0,0,0,1,0,0,0,0,0,0,1,0,1,0,0,0,0,0,1,0,0,1,
-    0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1,0,0,0,1,0,1,0,1,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,1,0,0,0,0,1,1,
-    1,0,0,0,0,1,0,1,0,0,0,1,0,1,0,1,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1,0,0,0,0,1,1,1,0,0,0,1,1,
-    1,1,1,0,0,0,0,0,0,0,0,0,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,1,1,1,1,1,0,0,0,0,0,0,1,0,0,1,0,1,0,1,0,0,1,0,0,1,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,
-    0,0,0,1,0,0,0,1,0,1,0,1,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,1,0,1,0,0,0,0,0,0,0,1,0,1,0,0,1,0,1,0,0,1,0,0,1,1,
-    0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,
-    0,0,0,0,1,1,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,1,0,1,0,0,0,1,1,1,
-    1,0,0,0,0,0,0,1,0,0,0,0,1,1,0,0,1,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,
-    0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,1,1,1,0,0,0,0,0,1,0,0,0,0,0,
-    1,1,1,0,0,0,1,1,1,1,1,0,0,0,0,0,1,0,0,0,1,1,1,1,1,0,0,0,0,1,1,0,0,0,1,1,1,1,1,0,0,0,1,1,1,0,0,0,
-    0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,1,0,
-    0,1,0,0,0,1,0,0,0,1,1,0,0,0,0,1,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,1,1,0,0,0,1,0,0,0,0,0,0,0,1,0,0,0,
-    0,0,0,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,
-    0,0,0,1,0,0,0,0,0,0,0,0,0,0,1,0,0,1,0,0,1,1,0,0,1,0,1,0,0,0,0,0,0,0,0,1,0,0,0,0,0,1,0,0,0,0,1,0,
-    1,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,1,0,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,0,1,1,0,0,0,0,0,1,
-    1,0,0,0,0,0,0,0,1,0,0,0,1,1,1,1,1,0,0,0,1,0,0,0,0,0,0,0,0,1,0,0,0,1,0,1,0,1,0,0,0,0,1,0,0,0,0,0,
-    0,0,1,0,0,0,0,0,1,1,0,0,0,1,0,0,1,0,0,0,1,1,1,1,0,0,0,1,1,1,1,0,0,0,0,0,0,1,0,0,0,0,1,1,1,0,0,0,
-    1,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,
-    0,1,1,0,0,1,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1,0,0,1,1,1,1,1,0,0,0,0,0,0,1,0,0,1,0,0,0,1,
-    0,0,0,0,1,0,0,0,0,1,0,0,0,1,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,1,0,0,0,1,0,0,0,0,1,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,
-    1,0,0,0,0,0,0,0,1,0,0,1,0,0,0,1,0,0,0,0,1,0,0,0,0,1,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,1,0,0,0,0,1,1,1,1,1,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,1,0,0,0,0,1,0,0,0,0,1,
-    0,0,0,0,0,0,1,0,0,0,1,0,0,0,0,0,1,0,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,0,1,0,0,0,0,0,1,0,0,0,1,0,0,
-    0,0,0,1,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,1,0,0,0,
-    0,0,1,1,1,0,0,0,1,1,1,1,1,0,0,1,1,1,1,1,0,0,0,1,1,1,0,0,0,0,0,0,1,0,0,0,0,1,1,1,0,0,0,0,1,1,1,0,
-    0,0,0,1,0,0,0,0,0,0,1,1,1,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,
-    0,0,0,1,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,1,0,0,0,0,1,1,1,1,0,0,0,0,0,1,1,1,0,0,1,1,1,
-    1,0,0,0,1,1,1,1,1,0,0,1,1,1,1,1,0,0,0,0,1,1,1,0,0,1,0,0,0,1,0,0,1,1,1,1,1,0,0,0,0,0,0,1,0,0,1,0,
-    0,0,1,0,0,1,0,0,0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,0,1,1,1,0,0,0,1,0,0,0,1,0,0,0,1,0,1,0,0,0,1,
-    0,0,0,1,0,0,0,1,0,0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,0,1,0,0,0,0,0,1,0,0,0,1,0,0,
-    0,0,1,0,0,0,0,0,0,0,0,1,0,0,1,0,0,1,0,0,0,1,0,0,0,0,0,0,1,1,0,1,1,0,0,1,1,0,0,1,0,0,1,0,0,0,1,0,
-    0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,0,0,0,1,0,0,0,0,
-    0,0,1,0,0,0,0,0,0,1,0,0,0,1,0,0,0,0,1,0,0,0,0,0,0,0,0,1,0,0,1,0,1,0,0,0,0,1,0,0,0,0,0,0,1,0,1,0,
-    1,0,0,1,0,1,0,1,0,0,1,0,0,0,1,0,0,1,0,0,1,1,0,0,1,0,0,0,1,0,0,1,1,1,1,0,0,0,1,0,0,0,0,0,0,1,0,0,
-    0,1,0,0,1,1,1,1,0,0,0,1,1,1,1,0,0,0,1,0,0,0,0,0,0,1,1,1,1,1,0,0,0,0,1,0,0,0,0,0,0,0,0,1,0,0,1,1,
-    0,0,0,0,0,1,0,0,0,0,0,0,1,0,1,0,1,0,0,1,0,0,1,1,0,0,1,0,0,0,1,0,0,1,0,1,0,1,0,0,1,1,1,1,1,0,0,1,
-    0,0,0,1,0,0,1,0,0,0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,1,1,0,0,1,0,0,0,1,0,0,
-    0,0,1,0,0,0,0,0,0,0,0,1,0,0,1,1,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,
-    0,1,0,1,1,1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,0,0,0,1,0,0,0,0,
-    0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,0,0,1,0,0,0,0,1,0,0,0,1,0,0,1,0,1,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,
-    1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,0,1,0,0,0,0,0,1,0,0,
-    1,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,0,1,0,0,1,0,0,1,0,0,0,1,0,0,0,0,1,0,0,0,0,1,0,0,0,1,0,0,1,0,
-    0,1,0,0,0,1,0,0,0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,0,0,0,1,0,0,0,1,0,0,1,
-    1,1,1,0,0,0,0,0,1,1,1,0,0,1,1,1,0,0,0,0,1,1,1,1,1,0,0,1,0,0,0,0,0,0,0,0,1,1,1,0,0,1,0,0,0,1,0,0,
-    1,1,1,1,1,0,0,0,1,1,1,0,0,0,1,0,0,0,1,0,0,1,1,1,1,1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,0,1,1,1,0,0,
-    0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,1,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,1,1,1,1,0,0,0,0,1,1,1,0,0,0,1,1,1,1,0,0,0,0,1,1,1,1,0,0,1,1,1,1,1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,
-    0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,1,1,1,1,0,0,0,1,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,1,
-    0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,0,0,0,0,0,1,
-    0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,0,0,0,1,0,0,0,0,1,
-    0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1,0,0,0,0,1,0,1,0,0,0,0,0,0,0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,
-    0,0,0,1,0,0,1,0,0,0,0,0,0,0,0,1,0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,0,1,0,1,0,0,0,
-    0,1,0,1,0,0,0,0,0,0,1,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1,0,0,0,1,0,0,0,1,0,0,0,0,0,0,0,0,
-    0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,0,1,1,0,0,0,0,0,0,1,0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,1,
-    0,0,1,0,0,0,1,0,0,0,0,1,0,0,0,0,0,1,0,1,0,0,0,0,0,1,0,0,0,0,0,1,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,1,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,1,0,0,0,1,0,0,1,1,1,1,0,0,0,0,0,0,1,0,0,0,0,0,1,
-    0,0,0,0,1,0,0,0,1,0,0,0,1,0,1,0,0,0,1,0,1,0,1,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,1,
-    0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,1,0,0,1,
-    0,1,0,0,0,0,0,0,0,0,1,0,0,0,0,1,0,0,0,0,1,0,0,0,1,0,0,0,1,0,1,0,0,0,1,0,1,0,1,0,0,0,1,0,1,0,0,0,
-    0,0,1,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,1,0,0,0,0,0,0,1,0,0,0,1,0,0,1,0,0,1,0,0,0,0,0,0,0,1,0,0,0,0,1,0,0,0,0,1,0,0,0,1,0,0,0,0,1,0,0,
-    0,0,1,0,1,0,1,0,0,1,0,0,0,1,0,0,0,0,1,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,1,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,1,1,1,0,0,0,1,0,0,0,1,0,0,1,1,1,1,0,0,0,0,0,1,
-    0,0,0,0,0,1,1,1,0,0,0,0,0,1,0,0,0,0,1,1,0,1,1,0,0,1,0,0,0,1,0,0,0,0,1,0,0,0,0,1,1,1,1,1,0,0,0,1,
-    0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,1,1,1,
-    0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,1,0,0,0,1,0,
-    0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,1,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,
-    0,0,1,0,0,0,0,0,0,0,1,0,0,0,1,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,1,0,0,0,
-    0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,1,0,1,1,0,0,0,0,1,1,1,1,0,0,0,1,1,
-    1,1,0,0,0,1,1,1,0,0,0,1,1,1,1,1,0,0,0,1,1,1,1,0,0,1,0,1,1,0,0,0,1,1,1,0,0,0,0,0,1,1,1,0,0,0,1,0,
-    0,1,0,0,0,0,0,1,0,0,0,0,1,1,1,1,0,0,0,1,0,1,1,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,1,
-    1,0,0,1,0,0,1,0,0,0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,0,1,0,0,0,0,0,1,0,0,0,1,0,0,1,1,0,0,1,0,0,
-    0,0,1,0,0,0,0,0,0,0,1,0,0,0,1,0,1,0,0,0,0,0,0,1,0,0,0,0,1,0,1,0,1,0,0,1,1,0,0,1,0,0,1,0,0,0,1,0,
-    0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,1,0,0,0,1,0,0,1,0,0,0,0,0,0,1,0,0,0,1,0,0,1,1,1,1,1,0,0,0,1,0,0,0,
-    0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,0,0,1,0,0,0,0,0,0,0,1,0,0,0,1,1,0,0,0,0,0,0,0,1,0,0,0,0,1,0,1,0,
-    1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,0,0,0,0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,0,0,0,1,0,0,
-    0,1,0,0,1,0,0,0,0,0,0,0,1,0,0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,0,0,1,0,0,0,0,0,0,0,1,0,0,0,1,0,
-    1,0,0,0,0,0,0,1,0,0,0,0,1,0,1,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,0,0,0,0,0,0,0,1,0,0,0,1,0,0,1,
-    0,0,0,1,0,0,1,0,0,0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,0,0,0,0,1,0,0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,
-    0,0,1,0,0,0,0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,0,0,1,0,0,0,0,1,0,1,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,
-    0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,1,1,1,1,0,0,0,0,1,1,1,1,0,0,0,1,1,1,1,0,0,0,1,1,1,1,0,0,0,1,0,0,0,
-    0,0,0,1,1,1,1,0,0,1,0,0,0,1,0,0,1,1,1,1,1,0,0,0,0,0,1,0,0,0,1,0,0,0,1,0,0,0,0,0,1,1,0,0,1,0,1,0,
-    1,0,0,1,0,0,0,1,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,1,0,0,0,0,1,1,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    1,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,1,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,1,0,1,0,1,0,0,0,0,0,0,0,0,
-    0,1,0,1,1,0,0,0,0,1,1,1,1,0,0,1,0,1,1,1,0,0,0,1,1,1,1,0,0,1,1,1,1,1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,
-    0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,1,1,1,1,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,
-    0,0,0,1,0,0,1,0,0,0,0,0,0,0,0,0,0,1,1,0,0,1,0,0,1,0,0,0,1,0,0,1,1,0,0,0,0,0,1,0,0,0,0,0,0,0,1,0,
-    0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,0,1,0,1,0,0,0,1,0,0,0,1,0,0,0,0,0,1,0,0,0,0,0,
-    1,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,
-    0,0,0,0,0,0,0,1,1,0,0,0,0,0,1,0,0,0,0,0,1,0,0,0,1,0,0,0,1,0,1,0,0,0,1,0,1,0,1,0,0,0,0,1,0,0,0,0,
-    1,0,0,0,1,0,0,0,0,1,0,0,0,0,1,1,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,1,0,0,0,1,0,0,1,0,0,0,1,0,0,1,0,0,0,0,0,0,0,0,0,1,0,0,0,0,1,0,0,0,0,0,1,0,0,0,1,0,0,0,1,0,1,0,
-    0,0,1,0,1,0,1,0,0,0,0,1,0,0,0,0,1,0,0,0,1,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,1,0,0,1,0,0,1,1,0,0,1,0,0,0,0,0,0,0,0,0,0,1,0,0,0,1,0,
-    0,0,0,0,1,0,0,0,1,0,0,0,0,1,0,0,0,0,1,0,1,0,1,0,0,0,1,0,1,0,0,0,1,0,0,1,1,0,0,0,1,0,0,0,0,0,0,0,
-    1,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,1,1,0,1,0,0,1,
-    0,0,0,0,0,0,1,1,1,1,0,0,0,0,0,1,1,1,0,0,0,1,1,1,1,0,0,0,0,1,0,0,0,0,1,1,0,1,1,0,0,1,0,0,0,1,0,0,
-    0,1,1,0,1,0,0,1,1,1,1,1,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,1,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,0,0,0,0,0,1,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,
-    0,1,1,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,1,0,0,0,
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-};
@@ -84,6 +84,17 @@ tetro_type TETRO[7] = {
 };
 
 uint8_t matrix[MATRIX_H][MATRIX_W];
+uint16_t matrix_bits[MATRIX_H + 3];
+
+// Occupied rows of a piece in one orientation, shifted so that the
+// lowest row and leftmost column are at 0
+typedef struct tetro_mask {
+    uint8_t row, col;       // Offsets of the lowest row and leftmost column
+    uint8_t h, w;
+    uint16_t bits[4];       // From the lowest row up; 0 above h
+} tetro_mask;
+
+static tetro_mask MASK[7][4];
 
 uint32_t clear_count;
 uint8_t recent_clear[4][MATRIX_W];
@@ -123,10 +134,28 @@ void tetro_init()
                 printf(" (%u %u)", m[j][k][0], m[j][k][1]);
             putchar('\n');
         }*/
+        for (uint8_t o = 0; o < 4; o++) {
+            tetro_mask *k = &MASK[i][o];
+            uint8_t r0 = s, c0 = s, r1 = 0, c1 = 0;
+            for (uint8_t j = 0; j < 4; j++) {
+                if (r0 > m[o][j][0]) r0 = m[o][j][0];
+                if (r1 < m[o][j][0]) r1 = m[o][j][0];
+                if (c0 > m[o][j][1]) c0 = m[o][j][1];
+                if (c1 < m[o][j][1]) c1 = m[o][j][1];
+            }
+            k->row = r0;
+            k->col = c0;
+            k->h = r1 - r0 + 1;
+            k->w = c1 - c0 + 1;
+            memset(k->bits, 0, sizeof k->bits);
+            for (uint8_t j = 0; j < 4; j++)
+                k->bits[m[o][j][0] - r0] |= 1 << (m[o][j][1] - c0);
+        }
 #undef m
     }
 
     memset(matrix, MINO_NONE, sizeof matrix);
+    memset(matrix_bits, 0, sizeof matrix_bits);
     tetris_refill(0);
     tetris_refill(7);
     clear_count = 0;
@@ -171,17 +200,34 @@ void tetris_spawn()
     hold_used = false;
 }
 
+bool tetris_fits(uint8_t type, uint8_t ori, int8_t row, int8_t col)
+{
+    const tetro_mask *k = &MASK[type][ori];
+    int8_t r = row + k->row, c = col + k->col;
+    if (r < 0 || r + k->h > MATRIX_H || c < 0 || c + k->w > MATRIX_W)
+        return false;
+    const uint16_t *b = &matrix_bits[r];
+    return !((b[0] & (k->bits[0] << c)) | (b[1] & (k->bits[1] << c)) |
+        (b[2] & (k->bits[2] << c)) | (b[3] & (k->bits[3] << c)));
+}
+
+int8_t tetris_landing(uint8_t type, uint8_t ori, int8_t row, int8_t col)
+{
+    const tetro_mask *k = &MASK[type][ori];
+    int8_t r = row + k->row;
+    uint8_t c = col + k->col;
+    uint16_t m0 = k->bits[0] << c, m1 = k->bits[1] << c;
+    uint16_t m2 = k->bits[2] << c, m3 = k->bits[3] << c;
+    const uint16_t *b = matrix_bits;
+    while (r > 0 && !((b[r - 1] & m0) | (b[r] & m1) | (b[r + 1] & m2) | (b[r + 2] & m3)))
+        r--;
+    return r - k->row;
+}
+
 bool tetris_check(uint8_t check_lowest)
 {
-    uint8_t lowest = MATRIX_H;
-    for (uint8_t i = 0; i < 4; i++) {
-        uint8_t r = drop_pos[0] + TETRO[drop_type].mino[drop_ori][i][0];
-        uint8_t c = drop_pos[1] + TETRO[drop_type].mino[drop_ori][i][1];
-        if (r >= MATRIX_H || c >= MATRIX_W || matrix[r][c] != MINO_NONE)
-            return false;
-        if (lowest > r) lowest = r;
-    }
-    return (!check_lowest || lowest < MATRIX_HV);
+    if (!tetris_fits(drop_type, drop_ori, drop_pos[0], drop_pos[1])) return false;
+    return (!check_lowest || drop_pos[0] + MASK[drop_type][drop_ori].row < MATRIX_HV);
 }
 
 void tetris_lockdown()
@@ -189,7 +235,10 @@ void tetris_lockdown()
     for (uint8_t i = 0; i < 4; i++) {
         uint8_t r = drop_pos[0] + TETRO[drop_type].mino[drop_ori][i][0];
         uint8_t c = drop_pos[1] + TETRO[drop_type].mino[drop_ori][i][1];
-        if (r < MATRIX_H || c < MATRIX_W) matrix[r][c] = drop_type;
+        if (r < MATRIX_H && c < MATRIX_W) {
+            matrix[r][c] = drop_type;
+            matrix_bits[r] |= 1 << c;
+        }
     }
     drop_type = MINO_NONE;
 }
@@ -243,7 +292,7 @@ bool tetris_rotate(int8_t dir)
             }
             return true;
         }
-#undef m
+#undef r
     }
     drop_ori = od;
     drop_pos[0] = ox;
@@ -276,11 +325,7 @@ bool tetris_hold()
 
 int8_t tetris_ghost()
 {
-    int8_t ox = drop_pos[0];
-    while (tetris_check(0)) drop_pos[0]--;
-    int8_t ret = drop_pos[0] + 1;
-    drop_pos[0] = ox;
-    return ret;
+    return tetris_landing(drop_type, drop_ori, drop_pos[0], drop_pos[1]);
 }
 
 static inline uint32_t tetris_clearlines()
@@ -289,18 +334,17 @@ static inline uint32_t tetris_clearlines()
     for (uint8_t i = 0, j = 0, k = 0; i < MATRIX_H && j < MATRIX_HV; i++) {
         // i = current row to be checked
         // j = next row to copy in the matrix
-        bool line_cleared = true;
-        for (uint8_t c = 0; c < MATRIX_W; c++)
-            if (matrix[i][c] == MINO_NONE) { line_cleared = false; break; }
-        if (line_cleared) {
+        if (matrix_bits[i] == MATRIX_ROW_FULL) {
             ret |= (1 << i);
             clear_count++;
             for (uint8_t c = 0; c < MATRIX_W; c++) recent_clear[k][c] = matrix[i][c];
             k++;
         } else {
             // Copy a line
-            if (i != j)
-                for (uint8_t c = 0; c < MATRIX_W; c++) matrix[j][c] = matrix[i][c];
+            if (i != j) {
+                memcpy(matrix[j], matrix[i], MATRIX_W);
+                matrix_bits[j] = matrix_bits[i];
+            }
             j++;
         }
     }
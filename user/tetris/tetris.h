@@ -30,6 +30,10 @@ extern tetro_type TETRO[7];
 // Playfield
 
 extern uint8_t matrix[MATRIX_H][MATRIX_W];
+// Occupancy of matrix, bit c for column c. Three more rows, always
+// empty, let a piece be tested as four rows wherever it is.
+extern uint16_t matrix_bits[MATRIX_H + 3];
+#define MATRIX_ROW_FULL ((1 << MATRIX_W) - 1)
 
 extern uint32_t clear_count;
 extern uint8_t recent_clear[4][MATRIX_W];
@@ -52,6 +56,10 @@ void tetro_init();
 
 void tetris_refill(uint8_t start);
 void tetris_spawn();
+// Whether a piece fits at {row, column}, counted as drop_pos
+bool tetris_fits(uint8_t type, uint8_t ori, int8_t row, int8_t col);
+// Row a piece that fits at {row, column} lands on
+int8_t tetris_landing(uint8_t type, uint8_t ori, int8_t row, int8_t col);
 bool tetris_check(uint8_t check_lowest);
 void tetris_lockdown();
 bool tetris_drop();